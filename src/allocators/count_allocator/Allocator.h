@@ -18,9 +18,14 @@ namespace count {
 
     class MemoryCount {
     private:
-        MemoryCount(): cur_bytes_(0), peak_bytes_(0) {};
+        MemoryCount(): cur_bytes_(0), peak_bytes_(0), bytes_limit_(0),
+                       alloc_calls_(0), dealloc_calls_(0) {};
         size_t cur_bytes_;
         size_t peak_bytes_;
+        // 0 means no limit
+        size_t bytes_limit_;
+        size_t alloc_calls_;
+        size_t dealloc_calls_;
     public:
         MemoryCount(const MemoryCount&) = delete;
         MemoryCount& operator=(const MemoryCount&) = delete;
@@ -46,14 +51,45 @@ namespace count {
             return peak_bytes_;
         }
 
+        /**
+         * Set a hard limit of the current used bytes, an allocation that makes
+         * cur_bytes() exceed the limit will throw std::bad_alloc.
+         * @param limit the max bytes, 0 means no limit
+         */
+        void SetBytesLimit(size_t limit) {
+            bytes_limit_ = limit;
+        }
+
+        size_t bytes_limit() const {
+            return bytes_limit_;
+        }
+
+        // The number of allocate() calls since the program starts
+        size_t alloc_calls() const {
+            return alloc_calls_;
+        }
+
+        // The number of deallocate() calls since the program starts
+        size_t dealloc_calls() const {
+            return dealloc_calls_;
+        }
+
     private:
-        // This two methods should only be called by
+        // These methods should only be called by CountAllocator
+        void CheckBytesLimit(size_t bytes) const {
+            if (bytes_limit_ != 0 && cur_bytes_ + bytes > bytes_limit_) {
+                throw std::bad_alloc();
+            }
+        }
+
         void UseMemory(size_t bytes) {
+            ++alloc_calls_;
             cur_bytes_ += bytes;
             peak_bytes_ = std::max(cur_bytes_, peak_bytes_);
         }
 
         void ReclaimMemory(size_t bytes) {
+            ++dealloc_calls_;
             cur_bytes_ -= bytes;
         }
 
@@ -77,10 +113,16 @@ namespace count {
             return true;
         }
 
+        friend bool operator!=(const CountAllocator&, const CountAllocator&) {
+            return false;
+        }
+
         T *allocate(std::size_t n) {
+            size_t used_bytes = n * sizeof(T);
+            // throw before the real allocation if the bytes limit is exceeded
+            MemoryCount::instance().CheckBytesLimit(used_bytes);
             // may throw
             void *p = std::allocator<T>{}.allocate(n);
-            size_t used_bytes = n * sizeof(T);
             MemoryCount::instance().UseMemory(used_bytes);
             return static_cast<T *>(p);
         }
@@ -35,6 +35,10 @@ namespace thp {
             return true;
         }
 
+        friend bool operator!=(const ThpAllocator&, const ThpAllocator&) {
+            return false;
+        }
+
         T *allocate(std::size_t n) {
 #if ENABLE_THP_ALLOC || ENABLE_THP_PRE_FAULTS
             size_t bytes_num = n * sizeof(T);
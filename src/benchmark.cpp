@@ -5,12 +5,20 @@
 #include <cinttypes>
 #include <sstream>
 #include <iomanip>
+#include <cmath>
+#include <filesystem>
 #include "Map.h"
 // for random generator
 #include "fph/dynamic_fph_table.h"
 #include "fph/meta_fph_table.h"
 #include "utils/cpu_timer.h"
 #include "utils/histogram_wrapper.h"
+#include "utils/composite_keys.h"
+#include "utils/mmap_key_file.h"
+#include "utils/fixed_string.h"
+#include "utils/hashed_key.h"
+#include "utils/hash_batch.h"
+#include "utils/hash_quality.h"
 #include "ska_flat_hash_map/flat_hash_map.hpp"
 
 // Add macOS QoS headers
@@ -168,11 +176,51 @@ struct MutableValue<T, typename std::enable_if<is_pair<T>::value>::type> {
     using type = std::pair<typename std::remove_const<typename T::first_type>::type, typename T::second_type>;
 };
 
+// The hash of the key sets used to generate unique keys, std::hash does not support
+// the composite keys
+template<class Key, class = void>
+struct KeySetHash : std::hash<Key> {};
+
+template<class Key>
+struct KeySetHash<Key, typename std::enable_if<bench::is_composite_key_v<Key>>::type> {
+    size_t operator()(const Key& key) const noexcept {
+        auto [high, low] = bench::ToWords(key);
+        return bench::Mix64(high ^ bench::Mix64(low));
+    }
+};
+
+template<class Key>
+struct KeySetHash<Key, typename std::enable_if<bench::is_fixed_string_v<Key>>::type> {
+    size_t operator()(const Key& key) const noexcept {
+        return std::hash<std::string_view>{}(key.view());
+    }
+};
+
+template<class Key>
+using KeySet = ska::flat_hash_set<Key, KeySetHash<Key>>;
+
 template<class T>
 std::string ToString(const T& t) {
     return std::to_string(t);
 }
 
+template<class T1, class T2>
+std::string ToString(const std::pair<T1, T2>& t) {
+    return "(" + ToString(t.first) + ", " + ToString(t.second) + ")";
+}
+
+#ifdef __SIZEOF_INT128__
+std::string ToString(__uint128_t t) {
+    char buf[40];
+    snprintf(buf, sizeof(buf), "0x%016" PRIx64 "%016" PRIx64, uint64_t(t >> 64U), uint64_t(t));
+    return buf;
+}
+#endif
+
+std::string ToString(const bench::Pod16Key& t) {
+    return "(" + ToString(t.tenant_id) + ", " + ToString(t.shard_id) + ", " + ToString(t.object_id) + ")";
+}
+
 
 std::string ToString(const std::string& t) {
     return t;
@@ -191,6 +239,37 @@ std::string ToString(const char* src) {
     return src;
 }
 
+template<size_t N>
+std::string ToString(const bench::FixedString<N>& t) {
+    return ToString(t.view());
+}
+
+inline uint64_t ReadBytes(const void* src, size_t length) {
+    const char* src_ptr = static_cast<const char*>(src);
+    uint64_t sum = 0;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, src_ptr + i, sizeof(uint64_t));
+        sum += word;
+    }
+    for (; i < length; ++i) {
+        sum += uint8_t(src_ptr[i]);
+    }
+    return sum;
+}
+
+// Read all the bytes of the object (the chars for a string) and return the sum
+template<class T>
+inline uint64_t ReadAllBytes(const T& x) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        return ReadBytes(x.data(), x.size());
+    }
+    else {
+        return ReadBytes(std::addressof(x), sizeof(T));
+    }
+}
+
 using CpuTimer = cpu_t::CpuTimer<uint64_t>;
 
 namespace detail {
@@ -206,6 +285,47 @@ namespace detail {
     template<class T>
     struct has_max_load_factor<T, typename voider<decltype(std::declval<T>().max_load_factor(0.5f))>::type> : std::true_type{};
 
+    // extract(key) returns a node handle which can be inserted into another table
+    template<class T, class = void>
+    struct has_node_handle : std::false_type{};
+
+    template<class T>
+    struct has_node_handle<T, typename voider<decltype(std::declval<T&>().insert(
+            std::declval<T&>().extract(std::declval<const typename T::key_type&>())))>::type> : std::true_type{};
+
+    template<class T, class = void>
+    struct is_less_comparable : std::false_type{};
+
+    template<class T>
+    struct is_less_comparable<T, typename voider<decltype(std::declval<const T&>() < std::declval<const T&>())>::type>
+            : std::true_type{};
+
+    // erase(iterator) returns the iterator following the erased element
+    template<class T, class = void>
+    struct erase_returns_iterator : std::false_type{};
+
+    template<class T>
+    struct erase_returns_iterator<T, typename std::enable_if<std::is_same_v<typename T::iterator,
+            decltype(std::declval<T&>().erase(std::declval<typename T::iterator>()))>>::type> : std::true_type{};
+
+    template<class T, class = void>
+    struct has_merge : std::false_type{};
+
+    template<class T>
+    struct has_merge<T, typename voider<decltype(std::declval<T&>().merge(std::declval<T&>()))>::type> : std::true_type{};
+
+    // The RNG of the keys not in the table, which is the key RNG itself unless it
+    // names another one as MissKeyRNGType
+    template<class RNG, class = void>
+    struct miss_key_rng {
+        using type = RNG;
+    };
+
+    template<class RNG>
+    struct miss_key_rng<RNG, std::void_t<typename RNG::MissKeyRNGType>> {
+        using type = typename RNG::MissKeyRNGType;
+    };
+
 } //namespace detail
 
 // The value of max_load_factor when we test the table rehashed with large
@@ -279,6 +399,17 @@ enum LookupExpectation {
     KEY_MAY_IN,
 };
 
+// The order of the keys to look up
+enum LookupOrder {
+    RANDOM_ORDER = 0,
+    INSERTION_ORDER,
+    KEY_SORTED_ORDER,
+    HASH_SORTED_ORDER, // the order a batching layer would produce
+    REVERSE_ORDER,
+};
+
+static constexpr const char* LOOKUP_ORDER_NAMES[] = {"random", "insertion_order", "key_sorted", "hash_sorted", "reverse"};
+
 template<class Table, bool measure_latency = false,
         class PairVec, class GetKey = SimpleGetKey<typename PairVec::value_type>>
 uint64_t TestTableEraseAndInsertImp(const PairVec& src_vec, const PairVec& new_ele_vec,
@@ -389,6 +520,49 @@ uint64_t TestTableEraseAndInsert(
 }
 
 
+/**
+ * Arrange the lookup keys, which are in the insertion order for the keys in the table, in the given order.
+ * Keys without operator< are sorted by their bytes.
+ */
+template<class GetKey, class PairVec, class RandomEngine>
+void ArrangeLookupOrder(PairVec& pair_vec, LookupOrder lookup_order, RandomEngine& random_engine) {
+    using KeyType = std::remove_cv_t<std::remove_reference_t<decltype(GetKey{}(pair_vec[0]))>>;
+    switch (lookup_order) {
+        case RANDOM_ORDER:
+            std::shuffle(pair_vec.begin(), pair_vec.end(), random_engine);
+            break;
+        case INSERTION_ORDER:
+            break;
+        case KEY_SORTED_ORDER:
+            std::sort(pair_vec.begin(), pair_vec.end(), [](const auto& a, const auto& b) {
+                if constexpr (detail::is_less_comparable<KeyType>::value) {
+                    return GetKey{}(a) < GetKey{}(b);
+                }
+                else {
+                    return memcmp(std::addressof(GetKey{}(a)), std::addressof(GetKey{}(b)), sizeof(KeyType)) < 0;
+                }
+            });
+            break;
+        case HASH_SORTED_ORDER: {
+            std::vector<std::pair<size_t, size_t>> hash_index_vec(pair_vec.size());
+            for (size_t i = 0; i < pair_vec.size(); ++i) {
+                hash_index_vec[i] = {static_cast<size_t>(Hash<KeyType>{}(GetKey{}(pair_vec[i]))), i};
+            }
+            std::sort(hash_index_vec.begin(), hash_index_vec.end());
+            PairVec temp_vec;
+            temp_vec.reserve(pair_vec.size());
+            for (const auto& [hash_value, index]: hash_index_vec) {
+                temp_vec.push_back(std::move(pair_vec[index]));
+            }
+            pair_vec = std::move(temp_vec);
+            break;
+        }
+        case REVERSE_ORDER:
+            std::reverse(pair_vec.begin(), pair_vec.end());
+            break;
+    }
+}
+
 template<LookupExpectation LOOKUP_EXP, bool verbose = true,
         bool measure_latency = false, class Table, class PairVec,
         class GetKey = SimpleGetKey<typename PairVec::value_type> >
@@ -398,7 +572,8 @@ std::tuple<uint64_t, uint64_t> TestTableLookUp(Table &table, size_t lookup_time,
                                                size_t seed,
                                                bool set_load_factor,
                                                CpuTimer& cpu_timer,
-                                               hist::HistWrapper *hist = nullptr) {
+                                               hist::HistWrapper *hist = nullptr,
+                                               LookupOrder lookup_order = RANDOM_ORDER) {
 
     size_t look_up_index = 0;
     size_t key_num = input_vec.size();
@@ -418,11 +593,19 @@ std::tuple<uint64_t, uint64_t> TestTableLookUp(Table &table, size_t lookup_time,
     }
     auto end_construct_t = std::chrono::high_resolution_clock::now();
     auto construct_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_construct_t - start_construct_t).count();
-    std::shuffle(pair_vec.begin(), pair_vec.end(), random_engine);
+    ArrangeLookupOrder<GetKey>(pair_vec, lookup_order, random_engine);
 
 //    size_t test_timeout_cnt = 0;
     {
-        constexpr int64_t per_find_timeout_threshold_ns = 1500LL; // 1500 ns per call
+        int64_t per_find_timeout_threshold_ns = 1500LL; // 1500 ns per call
+        if constexpr (std::is_same_v<typename Table::key_type, std::string>) {
+            // The long string keys take more time to hash and compare, allow 4 ns more per byte
+            size_t max_key_len = 0;
+            for (size_t i = 0; i < std::min(key_num, size_t(1000)); ++i) {
+                max_key_len = std::max(max_key_len, GetKey{}(pair_vec[i]).size());
+            }
+            per_find_timeout_threshold_ns += 4LL * int64_t(max_key_len);
+        }
         const size_t timeout_test_lookup_cnt = 100000LL;
         const int64_t total_timeout_threshold_ns = per_find_timeout_threshold_ns * timeout_test_lookup_cnt;
 
@@ -556,7 +739,7 @@ std::tuple<uint64_t, uint64_t> TestTableIterate(Table &table,
 
 template<class T, class RNG>
 void ConstructRngPtr(std::unique_ptr<RNG>& key_rng_ptr, size_t seed, size_t max_possible_value) {
-    if constexpr(std::is_integral_v<T> || std::is_same_v<T, std::string>) {
+    if constexpr(std::is_constructible_v<RNG, size_t, size_t>) {
         key_rng_ptr = std::make_unique<RNG>(seed, max_possible_value);
     }
     else {
@@ -565,11 +748,125 @@ void ConstructRngPtr(std::unique_ptr<RNG>& key_rng_ptr, size_t seed, size_t max_
     }
 }
 
+// Generate element_num values whose keys are not in key_set, the generated keys
+// are inserted into key_set as well
+template<class ValueRandomGen, class key_type, class mapped_type, class value_type,
+        class GetKey = SimpleGetKey<value_type>>
+std::vector<typename MutableValue<value_type>::type> GenUniqueValueVec(
+        size_t element_num, size_t max_possible_value, size_t seed,
+        KeySet<key_type>& key_set) {
+    using KeyRNG = typename ValueRandomGen::KeyRNGType;
+    using ValueRNG = typename ValueRandomGen::ValueRNGType;
+
+    std::unique_ptr<KeyRNG> key_rng_ptr;
+    std::unique_ptr<ValueRNG> value_rng_ptr;
+    ConstructRngPtr<key_type, KeyRNG>(key_rng_ptr, seed, max_possible_value);
+    ConstructRngPtr<mapped_type, ValueRNG>(value_rng_ptr, seed, max_possible_value);
+    ValueRandomGen value_gen{seed, std::move(*key_rng_ptr), std::move(*value_rng_ptr)};
+
+    std::vector<typename MutableValue<value_type>::type> ret_vec;
+    ret_vec.reserve(element_num);
+    key_set.reserve(key_set.size() + element_num);
+    for (size_t i = 0; i < element_num; ++i) {
+        auto temp_pair = value_gen();
+        while (key_set.find(GetKey{}(temp_pair)) != key_set.end()) {
+            temp_pair = value_gen();
+        }
+        key_set.insert(GetKey{}(temp_pair));
+        ret_vec.push_back(std::move(temp_pair));
+    }
+    return ret_vec;
+}
+
+#ifdef BENCH_TRAINED_HASH
+/**
+ * Train the hash (in src/trained-hashes) on the keys of the values before the tables are
+ * built, the time to copy the keys out of the values is not included in training_ns. The
+ * hash_mode is the variant chosen by the training, where 0 is the untrained version. The
+ * hash falls back to its untrained version when the scope ends, so the tables built later
+ * with other keys do not use a model trained for these keys.
+ */
+template<class Key>
+class HashTrainingScope {
+public:
+    template<class ValueVec, class GetKey>
+    HashTrainingScope(const ValueVec& value_vec, GetKey get_key) {
+        std::vector<Key> key_vec;
+        key_vec.reserve(value_vec.size());
+        for (const auto& value: value_vec) {
+            key_vec.push_back(get_key(value));
+        }
+        auto start_t = std::chrono::high_resolution_clock::now();
+        hash_mode = TrainHash(key_vec);
+        auto end_t = std::chrono::high_resolution_clock::now();
+        training_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count();
+    }
+
+    HashTrainingScope(const HashTrainingScope&) = delete;
+    HashTrainingScope& operator=(const HashTrainingScope&) = delete;
+
+    ~HashTrainingScope() {
+        TrainHash(std::vector<Key>{});
+    }
+
+    uint64_t training_ns;
+    int hash_mode;
+};
+#endif
+
+// Find lookup_time keys from the lookup_vec (in order, wrap around) in a table
+// that is already constructed. Return the total ns, or 0 if timeout.
+template<class Table, class PairVec, class GetKey = SimpleGetKey<typename PairVec::value_type>>
+uint64_t TimeTableFind(const Table &table, size_t lookup_time, const PairVec &lookup_vec) {
+    if (lookup_vec.empty() || lookup_time == 0) {
+        return 0;
+    }
+    constexpr int64_t look_up_timeout_threshold_ns = 1'000'000'000LL * 120LL; // 120 sec timeout
+    const size_t key_num = lookup_vec.size();
+    const size_t one_sub_lookup_cnt = std::max(std::min(lookup_time / 10UL, size_t(10000000UL)), size_t(1));
+    size_t look_up_index = 0;
+    int64_t total_sub_task_ns = 0;
+    for (size_t looked_cnt = 0; looked_cnt < lookup_time;) {
+        size_t sub_lookup_time = std::min(one_sub_lookup_cnt, lookup_time - looked_cnt);
+        auto sub_start_t = std::chrono::high_resolution_clock::now();
+        for (size_t t = 0; t < sub_lookup_time; ++t) {
+            ++look_up_index;
+            if FPH_UNLIKELY(look_up_index >= key_num) {
+                look_up_index -= key_num;
+            }
+            PreventElision(table.find(GetKey{}(lookup_vec[look_up_index])));
+        }
+        auto sub_end_t = std::chrono::high_resolution_clock::now();
+        total_sub_task_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                sub_end_t - sub_start_t).count();
+        looked_cnt += sub_lookup_time;
+        if FPH_UNLIKELY(total_sub_task_ns > look_up_timeout_threshold_ns) {
+            fprintf(stderr, "Timeout when time find %s with %s\n", MAP_NAME, HASH_NAME);
+            return 0;
+        }
+    }
+    return total_sub_task_ns;
+}
+
 // see ExportToCsv to get the info about StatsTuple
 #ifdef USE_COUNT_ALLOC
-inline constexpr size_t STATS_TUPLE_SIZE = 17;
+inline constexpr size_t BASE_STATS_TUPLE_SIZE = 17;
 #else
-inline constexpr size_t STATS_TUPLE_SIZE = 13;
+inline constexpr size_t BASE_STATS_TUPLE_SIZE = 13;
+#endif
+#ifdef BENCH_HASH_DECOMPOSITION
+// the hash, probe and remaining ns of the hit, miss and 50% hit lookups with the default load factor
+inline constexpr size_t LOOKUP_DECOMPOSITION_SIZE = 9;
+#else
+inline constexpr size_t LOOKUP_DECOMPOSITION_SIZE = 0;
+#endif
+inline constexpr size_t STATS_TUPLE_SIZE = BASE_STATS_TUPLE_SIZE + LOOKUP_DECOMPOSITION_SIZE;
+// the indices of the StatsTuple items read outside of ExportToCsv, in the order of its header
+inline constexpr size_t HIT_DEFAULT_LOOKUP_NS_INDEX = 5;
+inline constexpr size_t MISS_DEFAULT_LOOKUP_NS_INDEX = 6;
+#ifdef USE_COUNT_ALLOC
+inline constexpr size_t FINAL_DEFAULT_SIZE_MB_INDEX = 13;
+static_assert(FINAL_DEFAULT_SIZE_MB_INDEX < BASE_STATS_TUPLE_SIZE);
 #endif
 using StatsTuple = std::array<double, STATS_TUPLE_SIZE>;
 using TimeoutFlagArr = std::array<bool, std::tuple_size_v<StatsTuple>>;
@@ -600,6 +897,78 @@ HistResults GetHistResults(hist::HistWrapper& hist) {
     return results;
 }
 
+#ifdef BENCH_HASH_DECOMPOSITION
+/**
+ * Split a lookup test of TestTableLookUp into the hash and the probe. The hash alone is
+ * Table::hasher called on the keys of the same lookup stream, and the probe alone is the same
+ * lookup test on the table of HashedKey, whose keys carry the hash values computed before the
+ * test, so the table hashes them by returning the stored value (see PassthroughHash of each
+ * Hash.h). Both runs shuffle the lookup keys with the same seed as the full run.
+ * @return the total ns of the hash alone and of the probe alone, 0 if timeout
+ */
+template<LookupExpectation LOOKUP_EXP, class Table, class PairVec,
+        class GetKey = SimpleGetKey<typename PairVec::value_type>>
+std::tuple<uint64_t, uint64_t> DecomposeTableLookUp(size_t lookup_time, const PairVec& input_vec,
+                                                    const PairVec& lookup_vec, size_t seed,
+                                                    CpuTimer& cpu_timer) {
+    using HashedKeyType = bench::HashedKey<typename Table::key_type>;
+    using mapped_type = typename Table::mapped_type;
+    using HashedTable = Map<HashedKeyType, mapped_type>;
+    using HashedPairVec = std::vector<std::pair<HashedKeyType, mapped_type>>;
+    constexpr int64_t hash_timeout_threshold_ns = 1'000'000'000LL * 120LL; // 120 sec timeout
+
+    const size_t key_num = lookup_vec.size();
+    if (input_vec.empty() || key_num == 0) {
+        return {0, 0};
+    }
+    const typename Table::hasher hasher{};
+    uint64_t hash_ns = 0;
+    {
+        std::mt19937_64 random_engine(seed);
+        auto pair_vec = lookup_vec;
+        ArrangeLookupOrder<GetKey>(pair_vec, RANDOM_ORDER, random_engine);
+        size_t look_up_index = 0;
+        auto start_t = std::chrono::high_resolution_clock::now();
+        for (size_t t = 0; t < lookup_time; ++t) {
+            ++look_up_index;
+            if FPH_UNLIKELY(look_up_index >= key_num) {
+                look_up_index -= key_num;
+            }
+            PreventElision(hasher(GetKey{}(pair_vec[look_up_index])));
+        }
+        auto end_t = std::chrono::high_resolution_clock::now();
+        hash_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count();
+        if (hash_ns > uint64_t(hash_timeout_threshold_ns)) {
+            fprintf(stderr, "Timeout when test hash alone %s with %s\n", MAP_NAME, HASH_NAME);
+            hash_ns = 0;
+        }
+    }
+
+    uint64_t probe_ns = 0;
+    try {
+        auto to_hashed_vec = [&hasher](const PairVec& pair_vec) {
+            HashedPairVec hashed_vec;
+            hashed_vec.reserve(pair_vec.size());
+            for (const auto& pair: pair_vec) {
+                const auto& key = GetKey{}(pair);
+                hashed_vec.emplace_back(HashedKeyType(hasher(key), key), pair.second);
+            }
+            return hashed_vec;
+        };
+        HashedPairVec hashed_input_vec = to_hashed_vec(input_vec);
+        HashedPairVec hashed_lookup_vec = &lookup_vec == &input_vec ? hashed_input_vec : to_hashed_vec(lookup_vec);
+        HashedTable table;
+        std::tie(probe_ns, std::ignore) = TestTableLookUp<LOOKUP_EXP, false>(
+                table, lookup_time, hashed_input_vec, hashed_lookup_vec, seed, false, cpu_timer);
+    } catch(std::exception &e) {
+        fprintf(stderr, "Catch exception when test probe alone, element_num: %lu\n%s\n",
+                input_vec.size(), e.what());
+        probe_ns = 0;
+    }
+    return {hash_ns, probe_ns};
+}
+#endif
+
 template<class ValueRandomGen, class Table, class value_type,
         class GetKey = SimpleGetKey<value_type>>
 std::tuple<StatsTuple, HistResultsArray> TestTablePerformance(
@@ -623,7 +992,7 @@ std::tuple<StatsTuple, HistResultsArray> TestTablePerformance(
     ValueRandomGen value_gen{seed, std::move(*key_rng_ptr), std::move(*value_rng_ptr)};
     value_gen.seed(seed);
 
-    ska::flat_hash_set<key_type> key_set;
+    KeySet<key_type> key_set;
 //    std::unordered_set<key_type> key_set;
     key_set.reserve(element_num);
 
@@ -638,22 +1007,33 @@ std::tuple<StatsTuple, HistResultsArray> TestTablePerformance(
         key_set.insert(GetKey{}(temp_pair));
     }
 
+#ifdef BENCH_TRAINED_HASH
+    HashTrainingScope<key_type> hash_training(src_vec, GetKey{});
+    fprintf(stderr, "Train %s on %zu keys use %.3f ms, hash mode %d\n", HASH_NAME, element_num,
+            double(hash_training.training_ns) / 1e6, hash_training.hash_mode);
+#endif
+
     using HashFunc = typename Table::hasher;
     {
         ska::flat_hash_set<size_t> hash_set;
         hash_set.reserve(src_vec.size());
         HashFunc hasher{};
+        size_t collision_cnt = 0;
         for (const auto& value: src_vec) {
             const auto& key = GetKey{}(value);
             auto hash_value = hasher(key);
             if (hash_set.find(hash_value) != hash_set.end()) {
-                fprintf(stderr, "Hash value collision in src_vec!\n");
+                ++collision_cnt;
             }
             else {
                 hash_set.emplace(hash_value);
             }
 
         }
+        if (collision_cnt != 0) {
+            fprintf(stderr, "%zu hash value collisions in src_vec of %zu keys, see BENCH_HASH_QUALITY\n",
+                    collision_cnt, src_vec.size());
+        }
 //        ska::flat_hash_map<size_t, key_type> hash_count_map;
 //        hash_count_map.reserve(src_vec.size());
 //        for (const auto &value: src_vec) {
@@ -819,12 +1199,14 @@ std::tuple<StatsTuple, HistResultsArray> TestTablePerformance(
     // the miss keys are generated with the similar pattern as the elements
     std::vector<mutable_value_type> lookup_vec;
     lookup_vec.reserve(src_vec.size());
-    std::unique_ptr<KeyRNG> miss_key_rng_ptr;
+    using MissKeyRNG = typename detail::miss_key_rng<KeyRNG>::type;
+    using MissValueRandomGen = typename ValueRandomGen::template RebindKeyRNG<MissKeyRNG>;
+    std::unique_ptr<MissKeyRNG> miss_key_rng_ptr;
     size_t miss_value_max_num = std::max(std::max(lookup_time, element_num), erase_time) * 4ULL;
 //    size_t miss_value_max_num = std::numeric_limits<size_t>::max();
-    ConstructRngPtr<key_type, KeyRNG>(miss_key_rng_ptr, random_engine(), miss_value_max_num);
+    ConstructRngPtr<key_type, MissKeyRNG>(miss_key_rng_ptr, random_engine(), miss_value_max_num);
     ConstructRngPtr<mapped_type, ValueRNG>(value_rng_ptr, random_engine(), std::numeric_limits<size_t>::max());
-    ValueRandomGen miss_value_gen{random_engine(), std::move(*miss_key_rng_ptr), std::move(*value_rng_ptr)};
+    MissValueRandomGen miss_value_gen{random_engine(), std::move(*miss_key_rng_ptr), std::move(*value_rng_ptr)};
     for (size_t i = 0; i < src_vec.size(); ++i) {
         auto temp_pair = miss_value_gen();
 
@@ -840,7 +1222,7 @@ std::tuple<StatsTuple, HistResultsArray> TestTablePerformance(
 //    std::unordered_map<typename value_type::first_type,
 //            typename value_type::second_type> key_set;
 //        ska::flat_hash_map<size_t, key_type> hash_key_vec_map;
-        ska::flat_hash_set<typename value_type::first_type> new_key_set;
+        KeySet<typename value_type::first_type> new_key_set;
 //        hash_key_vec_map.reserve(src_vec.size() + max_possible_insert_cnt);
         ska::flat_hash_set<size_t> hash_set;
         hash_set.reserve(src_vec.size() + max_possible_insert_cnt);
@@ -859,6 +1241,7 @@ std::tuple<StatsTuple, HistResultsArray> TestTablePerformance(
         new_vec.reserve(max_possible_insert_cnt);
 
 
+        size_t collision_cnt = 0;
         for (size_t i = 0; i < max_possible_insert_cnt; ++i) {
             auto temp_new_value = miss_value_gen();
             while(new_key_set.find(GetKey{}(temp_new_value)) != new_key_set.end()) {
@@ -867,7 +1250,7 @@ std::tuple<StatsTuple, HistResultsArray> TestTablePerformance(
             const auto& new_key = GetKey{}(temp_new_value);
             auto new_hash_value = hasher(new_key);
             if (hash_set.find(new_hash_value) != hash_set.end()) {
-                fprintf(stderr, "Hash value collision in possible insert!\n");
+                ++collision_cnt;
             }
             else {
                 hash_set.emplace(new_hash_value);
@@ -893,6 +1276,10 @@ std::tuple<StatsTuple, HistResultsArray> TestTablePerformance(
             new_vec.emplace_back(temp_new_value);
             new_key_set.emplace(std::move(GetKey{}(temp_new_value)));
         }
+        if (collision_cnt != 0) {
+            fprintf(stderr, "%zu hash value collisions in possible insert of %zu keys\n",
+                    collision_cnt, max_possible_insert_cnt);
+        }
     }
 
     // test erase and insert
@@ -1206,6 +1593,48 @@ std::tuple<StatsTuple, HistResultsArray> TestTablePerformance(
     double avg_construct_time_with_reserve_ns = (double)total_reserve_construct_ns / (double)construct_time / (double)element_num;
     double avg_construct_time_without_reserve_ns = (double)total_no_reserve_construct_ns / (double)construct_time / (double)element_num;
     double avg_erase_insert_ns = (double)erase_and_insert_ns / (double)(erase_time * 2ULL);
+#ifdef BENCH_HASH_DECOMPOSITION
+    // split the lookups with the default load factor into the hash, the probe and the remaining cost
+    std::array<double, LOOKUP_DECOMPOSITION_SIZE> lookup_decomposition_arr{};
+    {
+        auto fill_decomposition = [&](uint64_t full_lookup_ns, std::tuple<uint64_t, uint64_t> part_ns_tuple,
+                                      double* decomposition_ptr) {
+            auto [hash_ns, probe_ns] = part_ns_tuple;
+            if (hash_ns == 0 || probe_ns == 0) {
+                return;
+            }
+            decomposition_ptr[0] = double(hash_ns) / double(lookup_time);
+            decomposition_ptr[1] = double(probe_ns) / double(lookup_time);
+            // may be negative, as the hash and the probe overlap in the full lookup
+            decomposition_ptr[2] = (double(full_lookup_ns) - double(hash_ns) - double(probe_ns))
+                                   / double(lookup_time);
+        };
+        if (in_no_rehash_lookup_ns != 0) {
+            fill_decomposition(in_no_rehash_lookup_ns, DecomposeTableLookUp<KEY_IN, Table>(
+                    lookup_time, src_vec, src_vec, construct_seed, cpu_timer), lookup_decomposition_arr.data());
+        }
+        if (out_no_rehash_lookup_ns != 0) {
+            fill_decomposition(out_no_rehash_lookup_ns, DecomposeTableLookUp<KEY_NOT_IN, Table>(
+                    lookup_time, src_vec, lookup_vec, construct_seed, cpu_timer), lookup_decomposition_arr.data() + 3);
+        }
+        if (may_no_hash_lookup_ns != 0) {
+            fill_decomposition(may_no_hash_lookup_ns, DecomposeTableLookUp<KEY_MAY_IN, Table>(
+                    lookup_time, src_vec, may_in_lookup_vec, construct_seed, cpu_timer),
+                    lookup_decomposition_arr.data() + 6);
+        }
+        // the probe is measured on the larger elements of the HashedKey table
+        using HashedElement = std::pair<bench::HashedKey<typename Table::key_type>, typename Table::mapped_type>;
+        fprintf(stderr, "%s with %s, %lu elements, hash / probe / remaining ns, find hit %.3f / %.3f / %.3f, "
+                        "find miss %.3f / %.3f / %.3f, find 50%% hit %.3f / %.3f / %.3f, "
+                        "element bytes %zu, probe table element bytes %zu\n",
+                MAP_NAME, HASH_NAME, element_num,
+                lookup_decomposition_arr[0], lookup_decomposition_arr[1], lookup_decomposition_arr[2],
+                lookup_decomposition_arr[3], lookup_decomposition_arr[4], lookup_decomposition_arr[5],
+                lookup_decomposition_arr[6], lookup_decomposition_arr[7], lookup_decomposition_arr[8],
+                sizeof(typename Table::value_type), sizeof(HashedElement));
+    }
+#endif
+
     double avg_hit_without_rehash_lookup_ns = (double)in_no_rehash_lookup_ns / (double)lookup_time;
     double avg_miss_without_rehash_lookup_ns = (double)out_no_rehash_lookup_ns / (double)lookup_time;
     double avg_may_without_rehash_lookup_ns = (double)may_no_hash_lookup_ns / (double)lookup_time;
@@ -1328,6 +1757,10 @@ std::tuple<StatsTuple, HistResultsArray> TestTablePerformance(
         with_rehash_peak_used_mb,
 #endif
     };
+#ifdef BENCH_HASH_DECOMPOSITION
+    std::copy(lookup_decomposition_arr.begin(), lookup_decomposition_arr.end(),
+              avg_time_arr.begin() + BASE_STATS_TUPLE_SIZE);
+#endif
 
 
     return {avg_time_arr, hist_results_arr};
@@ -1358,6 +1791,9 @@ public:
     using KeyRNGType = T1RNG;
     using ValueRNGType = T2RNG;
 
+    template<class NewT1RNG>
+    using RebindKeyRNG = RandomPairGen<T1, T2, NewT1RNG, T2RNG>;
+
 protected:
     T1RNG t1_gen;
     T2RNG t2_gen;
@@ -1368,18 +1804,25 @@ enum KeyBitsPattern{
     MASK_LOW_BITS,
     MASK_HIGH_BITS,
     MASK_SPLIT_BITS,
+    SEQUENTIAL, // dense sequential ids
+    SEQUENTIAL_WITH_GAPS, // sequential ids, about 1/4 of the steps skip up to 15 ids
+    POINTER_LIKE, // multiples of 8, 16 or 64 in a heap-like address range
+    TIMESTAMPS, // nanosecond timestamps increasing about 1 us per key, with +-1 us jitter
+    ENTROPY_BITS, // max(random_bits, ceil(log2(n))) random bits at split positions
 };
 
 
-template<KeyBitsPattern key_pattern>
+// Generate uint64_t keys in the pattern, ResultType can be a narrower unsigned type, in
+// which case the masks are generated in its digits
+template<KeyBitsPattern key_pattern, size_t random_bits = 0, class ResultType = uint64_t>
 class MaskedUint64RNG {
 public:
 
     MaskedUint64RNG(size_t seed, size_t max_element_size): init_seed(seed), random_engine(seed),
-                        mask(0){
+                        mask(0), cur_value(0) {
         size_t mask_len = fph::dynamic::detail::RoundUpLog2(max_element_size);
         if constexpr(key_pattern == MASK_LOW_BITS) {
-            size_t low_mask = fph::dynamic::detail::GenBitMask<uint64_t>(std::numeric_limits<size_t>::digits - mask_len);
+            size_t low_mask = fph::dynamic::detail::GenBitMask<uint64_t>(result_digits - mask_len);
             mask = ~low_mask;
         }
         else if constexpr(key_pattern == MASK_HIGH_BITS) {
@@ -1388,40 +1831,72 @@ public:
         else if constexpr(key_pattern == MASK_SPLIT_BITS) {
             mask = GenSplitMask(mask_len);
         }
-
+        else if constexpr(key_pattern == ENTROPY_BITS) {
+            size_t need_digits = std::max(mask_len, random_bits);
+            mask = need_digits >= result_digits ?
+                    std::numeric_limits<uint64_t>::max() : GenSplitMask(need_digits);
+        }
+        cur_value = GenInitValue();
     }
 
     MaskedUint64RNG(const MaskedUint64RNG& other): init_seed(other.init_seed),
                                                    random_engine(other.random_engine),
                                                    random_gen(other.random_gen),
-                                                   mask(other.mask) {}
+                                                   mask(other.mask),
+                                                   cur_value(other.cur_value) {}
 
     MaskedUint64RNG(MaskedUint64RNG&& other) noexcept:
             init_seed(std::exchange(other.init_seed, 0)),
             random_engine(std::move(other.random_engine)),
             random_gen(std::move(other.random_gen)),
-            mask(std::exchange(other.mask, 0)){}
+            mask(std::exchange(other.mask, 0)),
+            cur_value(std::exchange(other.cur_value, 0)) {}
 
     MaskedUint64RNG& operator=(MaskedUint64RNG&& other) noexcept {
         this->init_seed = std::exchange(other.init_seed, 0);
         this->random_engine = std::move(other.random_engine);
         this->random_gen = std::move(other.random_gen);
         this->mask = std::exchange(other.mask, 0);
+        this->cur_value = std::exchange(other.cur_value, 0);
         return *this;
     }
 
-    uint64_t operator()() {
+    ResultType operator()() {
+        if constexpr(key_pattern == SEQUENTIAL) {
+            return ResultType(cur_value++);
+        }
         auto ret = random_gen(random_engine);
 
-        if constexpr(key_pattern == MASK_HIGH_BITS || key_pattern == MASK_LOW_BITS || key_pattern == MASK_SPLIT_BITS) {
+        if constexpr(key_pattern == MASK_HIGH_BITS || key_pattern == MASK_LOW_BITS || key_pattern == MASK_SPLIT_BITS
+                     || key_pattern == ENTROPY_BITS) {
             ret &= mask;
         }
-        return ret;
+        else if constexpr(key_pattern == SEQUENTIAL_WITH_GAPS) {
+            cur_value += 1ULL + ((ret & 0x3ULL) == 0 ? (ret >> 2U) % 16ULL : 0ULL);
+            ret = cur_value;
+        }
+        else if constexpr(key_pattern == POINTER_LIKE) {
+            // Mostly bump allocations of the size classes, sometimes jump to new pages
+            constexpr uint64_t size_class_arr[] = {8ULL, 16ULL, 64ULL};
+            if ((ret & 0x3fULL) == 0) {
+                cur_value += 4096ULL * (1ULL + (ret >> 8U) % 256ULL);
+            }
+            else {
+                cur_value += size_class_arr[(ret >> 8U) % std::size(size_class_arr)];
+            }
+            ret = cur_value;
+        }
+        else if constexpr(key_pattern == TIMESTAMPS) {
+            cur_value += 500ULL + ret % 1000ULL;
+            ret = cur_value - 1000ULL + (ret >> 32U) % 2000ULL;
+        }
+        return ResultType(ret);
     }
 
     void seed(uint64_t seed = 0) {
         init_seed = seed;
         random_engine.seed(seed);
+        cur_value = GenInitValue();
     }
 
     size_t init_seed;
@@ -1430,9 +1905,27 @@ protected:
     std::mt19937_64 random_engine;
     std::uniform_int_distribution<uint64_t> random_gen;
     uint64_t mask;
+    // The last generated value of the sequential patterns
+    uint64_t cur_value;
+
+    uint64_t GenInitValue() {
+        if constexpr(key_pattern == SEQUENTIAL || key_pattern == SEQUENTIAL_WITH_GAPS) {
+            return random_gen(random_engine) >> 32U;
+        }
+        else if constexpr(key_pattern == POINTER_LIKE) {
+            return 0x7f0000000000ULL + ((random_gen(random_engine) >> 40U) << 12U);
+        }
+        else if constexpr(key_pattern == TIMESTAMPS) {
+            // Around the Unix time in ns of 2023-11
+            return 1'700'000'000'000'000'000ULL + (random_gen(random_engine) >> 20U);
+        }
+        return 0;
+    }
+
+    static constexpr size_t result_digits = std::numeric_limits<ResultType>::digits;
 
     static size_t GenSplitMask(size_t need_digits) {
-        constexpr size_t full_digits = std::numeric_limits<size_t>::digits;
+        constexpr size_t full_digits = result_digits;
         size_t padding_time = need_digits > 0UL ? need_digits - 1UL : 0UL;
         size_t padding_digits = full_digits - need_digits;
         size_t per_padding_digits = padding_digits  / padding_time;
@@ -1448,9 +1941,39 @@ protected:
 
 };
 
+// Generate the composite keys with two 64-bit generators, for the high and low words
+template<class Key, class HighRNG, class LowRNG>
+class CompositeKeyRNG {
+public:
+    CompositeKeyRNG(size_t seed, size_t max_element_size): init_seed(seed),
+            high_gen(seed, max_element_size), low_gen(~seed, max_element_size) {}
+
+    Key operator()() {
+        uint64_t high = high_gen();
+        return bench::FromWords<Key>(high, low_gen());
+    }
+
+    void seed(uint64_t seed = 0) {
+        init_seed = seed;
+        high_gen.seed(seed);
+        low_gen.seed(~seed);
+    }
+
+    size_t init_seed;
+
+protected:
+    HighRNG high_gen;
+    LowRNG low_gen;
+};
+
 enum StringRNGPattern {
     PRINTABLE_CHARS,
     SPLIT_MASK_BYTES,
+    URL_PATHS, // urls and paths with long shared prefixes
+    UUIDS, // version 4 uuid text, always 36 chars
+    IP_ADDRESSES, // dotted IPv4 and colon separated IPv6 text
+    DECIMAL_IDS, // decimal formatted 64-bit ids
+    LOG_NORMAL_LENGTH, // printable chars with log-normal distributed length
 };
 
 template<size_t max_len, StringRNGPattern pattern, bool fix_length = false>
@@ -1500,6 +2023,29 @@ public:
                 return GenSplitBitsBytes<max_len>(max_element_size, rand_int).substr(0, random_len);
             }
         }
+        else if constexpr (pattern == URL_PATHS) {
+            static_assert(max_len >= 128, "The generated url may be longer than max_len");
+            return RandomGenUrl();
+        }
+        else if constexpr (pattern == UUIDS) {
+            return RandomGenUuid();
+        }
+        else if constexpr (pattern == IP_ADDRESSES) {
+            return RandomGenIp();
+        }
+        else if constexpr (pattern == DECIMAL_IDS) {
+            // Ids of different magnitudes, from 20 to 64 bits
+            size_t bits = 20UL + random_gen(random_engine) % 45UL;
+            uint64_t id = random_gen(random_engine) >> (64UL - bits);
+            return std::to_string(id);
+        }
+        else if constexpr (pattern == LOG_NORMAL_LENGTH) {
+            // The median length is 20, which is around the SSO capacity of the std::string
+            // in libstdc++ (15) and libc++ (22)
+            std::lognormal_distribution<double> len_dis(std::log(20.0), 0.6);
+            double random_len = std::round(len_dis(random_engine));
+            return RandomGenStr(size_t(std::clamp(random_len, 1.0, double(max_len))));
+        }
     }
 
     void seed(uint64_t seed = 0) {
@@ -1514,6 +2060,60 @@ protected:
     std::mt19937_64 random_engine;
     std::uniform_int_distribution<uint64_t> random_gen;
 
+    std::string RandomGenUrl() {
+        static constexpr const char* host_arr[] = {
+                "https://www.example.com/", "https://api.example.com/",
+                "https://cdn.example-static.net/", "/var/www/html/"};
+        static constexpr const char* dir_arr[] = {
+                "api/", "v1/", "v2/", "users/", "orders/", "products/", "static/",
+                "images/", "assets/", "blog/", "2023/", "2024/", "search/", "docs/"};
+        std::string ret = host_arr[random_gen(random_engine) % std::size(host_arr)];
+        size_t dir_num = random_gen(random_engine) % 4UL;
+        for (size_t i = 0; i < dir_num; ++i) {
+            ret += dir_arr[random_gen(random_engine) % std::size(dir_arr)];
+        }
+        ret += RandomGenStr(4UL + random_gen(random_engine) % 9UL);
+        if (random_gen(random_engine) % 2UL == 0) {
+            ret += "?id=" + std::to_string(random_gen(random_engine) % 100'000'000ULL);
+        }
+        return ret;
+    }
+
+    std::string RandomGenUuid() {
+        uint64_t high = random_gen(random_engine), low = random_gen(random_engine);
+        high = (high & 0xffffffffffff0fffULL) | 0x0000000000004000ULL; // version 4
+        low = (low & 0x3fffffffffffffffULL) | 0x8000000000000000ULL; // variant 1
+        char buf[40];
+        snprintf(buf, sizeof(buf), "%08x-%04x-%04x-%04x-%012llx",
+                 uint32_t(high >> 32U), uint32_t((high >> 16U) & 0xffffU), uint32_t(high & 0xffffU),
+                 uint32_t(low >> 48U), (unsigned long long)(low & 0xffffffffffffULL));
+        return buf;
+    }
+
+    std::string RandomGenIp() {
+        char buf[48];
+        uint64_t rand_int = random_gen(random_engine);
+        if (rand_int & 0x1U) {
+            // IPv4, half of them are in 10.0.0.0/8
+            uint32_t ip = uint32_t(rand_int >> 32U);
+            if (rand_int & 0x2U) {
+                ip = (ip & 0x00ffffffU) | 0x0a000000U;
+            }
+            snprintf(buf, sizeof(buf), "%u.%u.%u.%u", ip >> 24U, (ip >> 16U) & 0xffU,
+                     (ip >> 8U) & 0xffU, ip & 0xffU);
+        }
+        else {
+            // IPv6 in one of a few /64 prefixes, with random interface ids
+            static constexpr const char* prefix_arr[] = {
+                    "2001:db8:0:1:", "2001:db8:85a3:8d3:", "fd00:1234:5678:9abc:", "fe80::"};
+            uint64_t iid = random_gen(random_engine);
+            snprintf(buf, sizeof(buf), "%s%x:%x:%x:%x", prefix_arr[(rand_int >> 1U) % std::size(prefix_arr)],
+                     uint32_t(iid >> 48U), uint32_t((iid >> 32U) & 0xffffU),
+                     uint32_t((iid >> 16U) & 0xffffU), uint32_t(iid & 0xffffU));
+        }
+        return buf;
+    }
+
     std::string RandomGenStr(size_t length) {
         static constexpr char alphanum[] =
                 "0123456789"
@@ -1570,6 +2170,17 @@ protected:
     }
 };
 
+// Generate the same keys as StringRNG<N, SPLIT_MASK_BYTES, true>, stored inline in FixedString<N>
+template<size_t N>
+class FixedStringRNG : public StringRNG<N, SPLIT_MASK_BYTES, true> {
+public:
+    using StringRNG<N, SPLIT_MASK_BYTES, true>::StringRNG;
+
+    bench::FixedString<N> operator()() {
+        return bench::FixedString<N>(StringRNG<N, SPLIT_MASK_BYTES, true>::operator()());
+    }
+};
+
 template<size_t size>
 struct FixSizeStruct {
     constexpr FixSizeStruct()noexcept: data{0} {}
@@ -1603,51 +2214,290 @@ protected:
     fph::dynamic::RandomGenerator<uint64_t> uint_gen;
 };
 
-constexpr char PathSeparator() {
-#ifdef BENCH_OS_WIN
-    return '\\';
-#else
-    return '/';
-#endif
-}
-
-namespace detail {
-    template<class T, class U, bool is_p = is_pair<T>::value && is_pair<U>::value>
-    struct ValueEqual {
-        constexpr bool operator()(const T& t, const U&u) const {
-            if constexpr (is_p) {
-                return t.first == u.first && t.second == u.second;
+// The number of low bits of the hash values which are the same for all the keys of the
+// adversarial datasets, unless the hash of the integers is the identity
+static constexpr size_t ADVERSARIAL_COLLIDE_BITS = 10;
+
+/**
+ * Generate the keys which collide in the tables that mask the hash value with a power of
+ * two bucket count. If Hash<uint64_t> is the identity (std::hash of libstdc++ and libc++),
+ * the low 32 bits of the integer keys are 0, so all the keys fall into the same bucket.
+ * Otherwise random keys are drawn until the low ADVERSARIAL_COLLIDE_BITS bits of the hash
+ * value are 0, which is what an attacker can do offline with an unseeded hash. The string
+ * keys share a long prefix, like the user input of a web service.
+ */
+template<class Key>
+class AdversarialKeyRNG {
+public:
+    AdversarialKeyRNG(): AdversarialKeyRNG(std::random_device{}()) {}
+    explicit AdversarialKeyRNG(size_t seed): init_seed(seed), random_engine(seed),
+                                             identity_hash(IsIdentityHash()) {}
+
+    Key operator()() {
+        constexpr size_t collide_mask = (size_t(1) << ADVERSARIAL_COLLIDE_BITS) - 1U;
+        if constexpr (std::is_same_v<Key, std::string>) {
+            static constexpr char alphanum[] =
+                    "0123456789"
+                    "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                    "abcdefghijklmnopqrstuvwxyz";
+            std::string key = "/api/v1/users/session/";
+            const size_t prefix_len = key.size();
+            key.resize(prefix_len + 16UL);
+            while (true) {
+                for (size_t i = prefix_len; i < key.size(); ++i) {
+                    key[i] = alphanum[random_engine() % (sizeof(alphanum) - 1)];
+                }
+                if ((static_cast<size_t>(Hash<Key>{}(key)) & collide_mask) == 0) {
+                    return key;
+                }
             }
-            else {
-                return t == u;
+        }
+        else {
+            if (identity_hash) {
+                return Key(random_engine() << 32U);
+            }
+            while (true) {
+                Key key = Key(random_engine());
+                if ((static_cast<size_t>(Hash<Key>{}(key)) & collide_mask) == 0) {
+                    return key;
+                }
             }
         }
-    };
-}; // namespace detail
+    }
 
-template<class Table1, class Table2, class GetKey1 = SimpleGetKey<typename Table1::value_type>,
-        class GetKey2 = SimpleGetKey<typename Table2::value_type>,
-        class ValueEqual = detail::ValueEqual<typename Table1::value_type, typename Table2::value_type>>
-bool IsTableSame(const Table1 &table1, const Table2 &table2) {
-    if (table1.size() != table2.size()) {
-        return false;
+    void seed(size_t seed) {
+        init_seed = seed;
+        random_engine.seed(seed);
     }
-    size_t table_size = table2.size();
-    size_t element_cnt = 0;
-    for (const auto& pair :table1) {
-        ++element_cnt;
-        auto find_it = table2.find(GetKey1{}(pair));
-        if FPH_UNLIKELY(find_it == table2.end()) {
-            fprintf(stderr, "Fail to find %s in table2, can find in table1 status: %d",
-                    ToString(GetKey1{}(pair)).c_str(), table1.find(GetKey1{}(pair)) != table1.end());
+
+    size_t init_seed;
+
+protected:
+    std::mt19937_64 random_engine;
+    bool identity_hash;
+
+    static bool IsIdentityHash() {
+        if constexpr (std::is_same_v<Key, std::string>) {
             return false;
         }
-        if FPH_UNLIKELY(!(ValueEqual{}(pair, *find_it))) {
-            return false;
+        else {
+            for (Key x: {Key(1), Key(0x12345678abcdefULL), Key(~uint64_t(0))}) {
+                if (static_cast<uint64_t>(Hash<Key>{}(x)) != uint64_t(x)) {
+                    return false;
+                }
+            }
+            return true;
         }
     }
-    if FPH_UNLIKELY(element_cnt != table_size) {
-        fprintf(stderr, "Table 1 iterate num not equals to table size");
+};
+
+// The key file given in the command line
+static const bench::MmapKeyFile* bench_key_file = nullptr;
+
+/**
+ * Read the keys from bench_key_file. The keys of the table are read in order from the
+ * beginning of the file, and the keys not in the table are read from the held out part
+ * at the end of the file. When a part is used up, it is read again from its beginning,
+ * with the round number appended to the string keys (or mixed into the integer keys),
+ * so that new keys can always be drawn.
+ */
+template<class Key, bool held_out = false>
+class FileKeyRNG {
+public:
+    using MissKeyRNGType = FileKeyRNG<Key, true>;
+
+    FileKeyRNG(): FileKeyRNG(0) {}
+    explicit FileKeyRNG(size_t seed): init_seed(seed),
+            begin_offset(held_out ? bench_key_file->held_out_offset() : 0),
+            end_offset(held_out ? bench_key_file->key_end_offset() : bench_key_file->held_out_offset()),
+            cur_offset(begin_offset), round(0) {}
+
+    Key operator()() {
+        if (cur_offset >= end_offset) {
+            cur_offset = begin_offset;
+            ++round;
+        }
+        if constexpr (std::is_same_v<Key, std::string>) {
+            std::string_view key_view;
+            cur_offset = bench_key_file->ReadKey(cur_offset, key_view);
+            if (key_view.empty()) {
+                // the empty lines at the end of the file
+                return (*this)();
+            }
+            std::string key(key_view);
+            if (round > 0) {
+                key += '#';
+                key += std::to_string(round);
+            }
+            return key;
+        }
+        else {
+            uint64_t word = 0;
+            cur_offset = bench_key_file->ReadKey(cur_offset, word);
+            return Key(round > 0 ? word ^ bench::Mix64(round) : word);
+        }
+    }
+
+    void seed(size_t seed) {
+        init_seed = seed;
+        cur_offset = begin_offset;
+        round = 0;
+    }
+
+    size_t init_seed;
+
+protected:
+    size_t begin_offset;
+    size_t end_offset;
+    size_t cur_offset;
+    size_t round;
+};
+
+// The values which are not trivially copyable. The heap memory they own is allocated
+// by Allocator, so it is counted when the count allocator is used.
+using HeapString = std::basic_string<char, std::char_traits<char>, Allocator<char>>;
+using HeapUint32Vec = std::vector<uint32_t, Allocator<uint32_t>>;
+
+// A value whose move constructor is not noexcept
+struct ThrowingMoveValue {
+    ThrowingMoveValue() = default;
+    explicit ThrowingMoveValue(HeapUint32Vec&& vec): data(std::move(vec)) {}
+    ThrowingMoveValue(const ThrowingMoveValue&) = default;
+    ThrowingMoveValue& operator=(const ThrowingMoveValue&) = default;
+    ThrowingMoveValue(ThrowingMoveValue&& other): data(std::move(other.data)) {}
+    ThrowingMoveValue& operator=(ThrowingMoveValue&& other) {
+        data = std::move(other.data);
+        return *this;
+    }
+
+    friend bool operator==(const ThrowingMoveValue& a, const ThrowingMoveValue& b) {
+        return a.data == b.data;
+    }
+
+    HeapUint32Vec data;
+};
+
+static_assert(!std::is_nothrow_move_constructible_v<ThrowingMoveValue>);
+
+// Generate HeapString, HeapUint32Vec or ThrowingMoveValue with a random length in [1, max_len]
+template<class ValueType, size_t max_len>
+class HeapValueRNG {
+public:
+    HeapValueRNG(): init_seed(std::random_device{}()), uint_gen(init_seed) {};
+    HeapValueRNG(size_t seed): init_seed(seed), uint_gen(seed) {}
+
+    ValueType operator()() {
+        size_t random_len = 1UL + uint_gen() % max_len;
+        if constexpr (std::is_same_v<ValueType, HeapString>) {
+            HeapString ret(random_len, '\0');
+            for (char &c: ret) {
+                c = char('a' + uint_gen() % 26U);
+            }
+            return ret;
+        }
+        else {
+            HeapUint32Vec vec(random_len);
+            for (uint32_t &x: vec) {
+                x = uint32_t(uint_gen());
+            }
+            if constexpr (std::is_same_v<ValueType, HeapUint32Vec>) {
+                return vec;
+            }
+            else {
+                return ValueType(std::move(vec));
+            }
+        }
+    }
+
+    void seed(size_t seed) {
+        init_seed = seed;
+        uint_gen.seed(seed);
+    }
+
+    size_t init_seed;
+
+protected:
+    fph::dynamic::RandomGenerator<uint64_t> uint_gen;
+};
+
+constexpr char PathSeparator() {
+#ifdef BENCH_OS_WIN
+    return '\\';
+#else
+    return '/';
+#endif
+}
+
+// Open the csv file at data_dir_path/sub_dir_name/file_name for writing, the
+// sub directory will be created if not exists. Return nullptr when failed.
+FILE* OpenExportFile(const std::string& data_dir_path, const std::string& sub_dir_name,
+                     const std::string& file_name) {
+    std::string export_dir_path = data_dir_path + sub_dir_name;
+    std::error_code ec;
+    std::filesystem::create_directories(export_dir_path, ec);
+    if (ec) {
+        fprintf(stderr, "Error when create directory %s\n%s\n", export_dir_path.c_str(),
+                ec.message().c_str());
+        return nullptr;
+    }
+    std::string export_file_path = export_dir_path + PathSeparator() + file_name;
+    FILE *export_fp = fopen(export_file_path.c_str(), "w");
+    if (export_fp == nullptr) {
+        fprintf(stderr, "Error when create file at %s\n%s\n", export_file_path.c_str(),
+                std::strerror(errno));
+    }
+    return export_fp;
+}
+
+// Write the csv header and the rows of the numbers, used by the extra test suites
+template<class Row>
+void ExportRowsToCsv(FILE* export_fp, const std::string& csv_header, const std::vector<Row>& row_vec) {
+    fprintf(export_fp, "%s\n", csv_header.c_str());
+    for (const auto& row: row_vec) {
+        for (size_t i = 0; i < row.size(); ++i) {
+            fprintf(export_fp, "%lf%s", double(row[i]), i + 1UL == row.size() ? "\n" : ",");
+        }
+    }
+    fclose(export_fp);
+}
+
+namespace detail {
+    template<class T, class U, bool is_p = is_pair<T>::value && is_pair<U>::value>
+    struct ValueEqual {
+        constexpr bool operator()(const T& t, const U&u) const {
+            if constexpr (is_p) {
+                return t.first == u.first && t.second == u.second;
+            }
+            else {
+                return t == u;
+            }
+        }
+    };
+}; // namespace detail
+
+template<class Table1, class Table2, class GetKey1 = SimpleGetKey<typename Table1::value_type>,
+        class GetKey2 = SimpleGetKey<typename Table2::value_type>,
+        class ValueEqual = detail::ValueEqual<typename Table1::value_type, typename Table2::value_type>>
+bool IsTableSame(const Table1 &table1, const Table2 &table2) {
+    if (table1.size() != table2.size()) {
+        return false;
+    }
+    size_t table_size = table2.size();
+    size_t element_cnt = 0;
+    for (const auto& pair :table1) {
+        ++element_cnt;
+        auto find_it = table2.find(GetKey1{}(pair));
+        if FPH_UNLIKELY(find_it == table2.end()) {
+            fprintf(stderr, "Fail to find %s in table2, can find in table1 status: %d",
+                    ToString(GetKey1{}(pair)).c_str(), table1.find(GetKey1{}(pair)) != table1.end());
+            return false;
+        }
+        if FPH_UNLIKELY(!(ValueEqual{}(pair, *find_it))) {
+            return false;
+        }
+    }
+    if FPH_UNLIKELY(element_cnt != table_size) {
+        fprintf(stderr, "Table 1 iterate num not equals to table size");
         return false;
     }
     element_cnt = 0;
@@ -1682,7 +2532,8 @@ int TestBasicCorrect(size_t seed) {
 
     {
         Table table;
-        std::unordered_map<typename value_type::first_type, typename value_type::second_type> bench_table;
+        std::unordered_map<typename value_type::first_type, typename value_type::second_type,
+                KeySetHash<typename value_type::first_type>> bench_table;
         const size_t element_num = 100;
         ConstructRngPtr<key_type, KeyRNG>(key_rng_ptr, seed, element_num);
         ConstructRngPtr<mapped_type, ValueRNG>(value_rng_ptr, seed, element_num);
@@ -1719,9 +2570,11 @@ int TestBasicCorrect(size_t seed) {
     return 0;
 }
 
+// max_erase_time caps the number of the new keys of the erase and insert test, for the keys
+// which are large or slow to generate
 template<class KeyType, class ValueType, class KeyRandomGen, class ValueRandomGen>
 auto TestOnePairType( size_t seed, const std::vector<size_t>& key_size_array,
-                      CpuTimer& cpu_timer) {
+                      CpuTimer& cpu_timer, size_t max_erase_time = std::numeric_limits<size_t>::max()) {
 
     using RandomGenerator = RandomPairGen<KeyType, ValueType, KeyRandomGen , ValueRandomGen>;
 
@@ -1769,6 +2622,7 @@ auto TestOnePairType( size_t seed, const std::vector<size_t>& key_size_array,
             CONSTRUCT_TIME = 2;
             ERASE_TIME = key_num;
         }
+        ERASE_TIME = std::min(ERASE_TIME, max_erase_time);
 
         if (already_time_out_flag) {
             fprintf(stderr, "%s with %s Already timeout for all lookups and erase test, not test for element size: %lu\n",
@@ -1850,6 +2704,14 @@ void ExportToCsv(FILE* export_fp, const std::vector<size_t>& element_num_vec,
     csv_header += ",final_default_load_factor_size_mb,peak_default_load_factor_size_mb"
                   ",final_large_load_factor_size_mb,peak_large_load_factor_size_mb";
 #endif
+#ifdef BENCH_HASH_DECOMPOSITION
+    csv_header += ",hit_default_load_factor_hash_ns,hit_default_load_factor_probe_ns"
+                  ",hit_default_load_factor_remaining_ns"
+                  ",miss_default_load_factor_hash_ns,miss_default_load_factor_probe_ns"
+                  ",miss_default_load_factor_remaining_ns"
+                  ",50%_hit_default_load_factor_hash_ns,50%_hit_default_load_factor_probe_ns"
+                  ",50%_hit_default_load_factor_remaining_ns";
+#endif
 #if BENCH_LATENCY
     csv_header.append(",");
     auto hist2hdr = [](const HistResults& hist){
@@ -1941,48 +2803,77 @@ bool IsStringOnlyHash(const std::string& hash_name) {
     return false;
 }
 
-void BenchTest(size_t seed, const char* data_dir) {
-#if defined(__APPLE__)
-    // Set QoS to highest priority for benchmark on macOS
-    pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0);
-    fprintf(stderr, "Set macOS QoS to USER_INTERACTIVE for benchmark process\n");
-#endif
-//    TestRNG();
-    using UniformUint64RNG = MaskedUint64RNG<UNIFORM>;
 #ifndef BENCH_ONLY_STRING
-    using MaskHighBitsUint64RNG = MaskedUint64RNG<MASK_HIGH_BITS>;
-    using MaskLowBitsUint64RNG = MaskedUint64RNG<MASK_LOW_BITS>;
-    using MaskSplitBitsUint64RNG = MaskedUint64RNG<MASK_SPLIT_BITS>;
-
-#endif
 
+static const char* WIDTH_MATRIX_CSV_HEADER = "element_num,sizeof_value_type,bytes_per_element,"
+                                             "avg_hit_lookup_ns,avg_miss_lookup_ns";
 
-    std::string map_name = std::string(MAP_NAME);
-    std::string hash_name = std::string(HASH_NAME);
-    std::string data_dir_path = std::string(data_dir) + PathSeparator();
+template<class T>
+constexpr const char* UintTypeName() {
+    static_assert(std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t>);
+    return std::is_same_v<T, uint32_t> ? "uint32_t" : "uint64_t";
+}
 
-    cpu_t::CpuTimer cpu_timer;
+/**
+ * Test the mid split bits masked keys of KeyType with values of ValueType. Besides the usual
+ * csv file, write the bytes per element (with the count allocator) and the lookup time to
+ * the width_matrix sub directory, to compare the tables with different slot sizes.
+ */
+template<class KeyType, class ValueType>
+void TestWidthPairType(size_t seed, const std::vector<size_t>& key_size_array, CpuTimer& cpu_timer,
+                       const std::string& data_dir_path) {
+    using KeyRNG = MaskedUint64RNG<MASK_SPLIT_BITS, 0, KeyType>;
+    using ValueRNG = MaskedUint64RNG<UNIFORM, 0, ValueType>;
+    std::string key_name = std::string("mask_split_bits_") + UintTypeName<KeyType>();
+    std::string file_name = std::string(MAP_NAME) + "__" + HASH_NAME + "__" + key_name + "__"
+            + UintTypeName<ValueType>() + ".csv";
+    fprintf(stderr, "\nTest mid split bits masked %s key and %s value\n\n",
+            UintTypeName<KeyType>(), UintTypeName<ValueType>());
+
+    std::string export_file_path = data_dir_path + file_name;
+    FILE *export_fp = fopen(export_file_path.c_str(), "w");
+    if (export_fp == nullptr) {
+        fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                std::strerror(errno));
+        return;
+    }
+    auto [result_vec, hist_arr_vec] = TestOnePairType<KeyType, ValueType, KeyRNG, ValueRNG>(
+            seed, key_size_array, cpu_timer);
+    ExportToCsv(export_fp, key_size_array, result_vec, hist_arr_vec, cpu_timer);
 
-#if BENCH_LATENCY
-    fprintf(stderr, "Cpu timer ns / per tick: %.10lf, overhead: %" PRId64 " ticks\n",
-            cpu_timer.ns_per_tick(), cpu_timer.overhead_ticks());
-#   ifdef USE_RAW_HISTOGRAM
-    fprintf(stderr, "Use raw histogram\n");
-#   else
-    fprintf(stderr, "Use Hdr histogram\n");
-#   endif
+    std::vector<std::array<double, 5>> width_row_vec;
+    for (size_t k = 0; k < key_size_array.size() && k < result_vec.size(); ++k) {
+        const auto& stats_tuple = result_vec[k];
+        double bytes_per_element = 0.0;
+#ifdef USE_COUNT_ALLOC
+        bytes_per_element = stats_tuple[FINAL_DEFAULT_SIZE_MB_INDEX] * 1024.0 * 1024.0 / double(key_size_array[k]);
 #endif
+        width_row_vec.push_back({double(key_size_array[k]),
+                                 double(sizeof(std::pair<KeyType, ValueType>)), bytes_per_element,
+                                 stats_tuple[HIT_DEFAULT_LOOKUP_NS_INDEX], stats_tuple[MISS_DEFAULT_LOOKUP_NS_INDEX]});
+    }
+    FILE *width_fp = OpenExportFile(data_dir_path, "width_matrix", file_name);
+    if (width_fp != nullptr) {
+        ExportRowsToCsv(width_fp, WIDTH_MATRIX_CSV_HEADER, width_row_vec);
+    }
+}
+
+// Test each std::pair<KeyType, ValueType> in the KeyValuePairs
+template<class... KeyValuePairs>
+void TestWidthMatrix(size_t seed, const std::vector<size_t>& key_size_array, CpuTimer& cpu_timer,
+                     const std::string& data_dir_path) {
+    (TestWidthPairType<typename KeyValuePairs::first_type, typename KeyValuePairs::second_type>(
+            seed, key_size_array, cpu_timer, data_dir_path), ...);
+}
 
-#ifdef ENABLE_THP_ALLOC
-#   if ENABLE_THP_ALLOC
-    fprintf(stderr, "Transparent Huge Page enabled\n");
-#   endif
 #endif
 
+// The element numbers of the default test items
+std::vector<size_t> DefaultKeySizeArray() {
     // When test memory size, half of the size has a 0.4 load factor, the other
     // half has a 0.6 load factor.
 #ifdef USE_COUNT_ALLOC
-    std::vector<size_t> key_size_array = {
+    return {
             32UL, 96UL, 153UL, 409UL, 614UL, 819UL, 1'228UL,
             1'638UL, 2'457UL, 3'276UL, 4'915UL, 6'553UL, 9'830UL, 13'107UL, 19'660UL,
             26'214UL, 39'321UL, 52'428UL, 78'643UL, 104'857UL, 157'286UL,
@@ -1993,7 +2884,7 @@ void BenchTest(size_t seed, const char* data_dir) {
 
 #else
     // Add some special key num like power of 2
-    std::vector<size_t> key_size_array = {
+    return {
         32UL, 110UL, 240UL, 500UL, 800UL, 1024UL, 1500UL,
         2048UL, 3000UL, 6000UL,
         8192UL, 12000UL,16384UL, 25000UL,
@@ -2005,6 +2896,206 @@ void BenchTest(size_t seed, const char* data_dir) {
         10000000UL
     };
 #endif
+}
+
+// The max key size of the adversarial datasets, the generation of the keys takes
+// 2^ADVERSARIAL_COLLIDE_BITS hashes per key, and the tables may degrade to O(n) per operation.
+// Also caps the new keys of the erase and insert test, which are adversarial keys as well
+static constexpr size_t ADVERSARIAL_MAX_KEY_NUM = 200'000ULL;
+
+/**
+ * Test the keys of AdversarialKeyRNG, to see the worst case cost of insert and lookup of
+ * each table with the hash, and which tables time out.
+ */
+template<class KeyType>
+void TestAdversarialKeys(size_t seed, const std::vector<size_t>& key_size_array, CpuTimer& cpu_timer,
+                         const std::string& data_dir_path, const std::string& key_name) {
+    using UniformUint64RNG = MaskedUint64RNG<UNIFORM>;
+    std::vector<size_t> adversarial_key_size_array;
+    for (size_t key_size: key_size_array) {
+        if (key_size <= ADVERSARIAL_MAX_KEY_NUM) {
+            adversarial_key_size_array.push_back(key_size);
+        }
+    }
+    fprintf(stderr, "\nTest adversarial %s key whose hash values collide\n\n", key_name.c_str());
+    FILE *export_fp = OpenExportFile(data_dir_path, "adversarial",
+            std::string(MAP_NAME) + "__" + HASH_NAME + "__" + "adversarial_" + key_name + "__uint64_t.csv");
+    if (export_fp == nullptr) {
+        return;
+    }
+    auto [result_vec, hist_arr_vec] = TestOnePairType<KeyType, uint64_t, AdversarialKeyRNG<KeyType>, UniformUint64RNG>(
+            seed, adversarial_key_size_array, cpu_timer, ADVERSARIAL_MAX_KEY_NUM);
+    ExportToCsv(export_fp, adversarial_key_size_array, result_vec, hist_arr_vec, cpu_timer);
+}
+
+/**
+ * Run the default test items with the keys read from a file, format is "string" for
+ * newline separated strings or "uint64" for a raw little-endian uint64_t array. The
+ * last 20% of the keys are held out as the keys not in the table.
+ */
+void BenchFileKeys(size_t seed, const char* data_dir, const char* key_file_path, const char* format) {
+    std::string map_name = std::string(MAP_NAME);
+    std::string hash_name = std::string(HASH_NAME);
+    std::string data_dir_path = std::string(data_dir) + PathSeparator();
+    std::string format_name = format == nullptr ? "string" : format;
+    if (format_name != "string" && format_name != "uint64") {
+        fprintf(stderr, "Invalid key file format %s, should be string or uint64\n", format_name.c_str());
+        return;
+    }
+    const bool is_string_key = format_name == "string";
+#ifdef BENCH_ONLY_INT
+    if (is_string_key) {
+        fprintf(stderr, "Only int keys are tested, skip the string key file %s\n", key_file_path);
+        return;
+    }
+#endif
+#ifdef BENCH_ONLY_STRING
+    if (!is_string_key) {
+        fprintf(stderr, "Only string keys are tested, skip the uint64 key file %s\n", key_file_path);
+        return;
+    }
+#endif
+    if (!is_string_key && IsStringOnlyHash(hash_name)) {
+        return;
+    }
+
+    auto key_file = bench::MmapKeyFile::Open(key_file_path, is_string_key ? bench::KeyFileFormat::LINES
+                                                                          : bench::KeyFileFormat::UINT64_LE);
+    if (key_file == nullptr) {
+        return;
+    }
+    bench_key_file = key_file.get();
+    std::vector<size_t> key_size_array;
+    for (size_t key_size: DefaultKeySizeArray()) {
+        if (key_size <= key_file->hit_key_num()) {
+            key_size_array.push_back(key_size);
+        }
+    }
+    // All the keys of the first 80% are also tested, up to the largest default size
+    const size_t max_key_size = std::min(key_file->hit_key_num(), DefaultKeySizeArray().back());
+    if (key_size_array.empty() || key_size_array.back() < max_key_size) {
+        key_size_array.push_back(max_key_size);
+    }
+
+    fprintf(stderr, "\n------ Begin to test %lu keys (%lu held out) from %s of hash %s with map %s ---\n",
+            key_file->key_num(), key_file->key_num() - key_file->hit_key_num(), key_file_path,
+            HASH_NAME, MAP_NAME);
+    std::string key_name = std::filesystem::path(key_file_path).stem().string();
+    FILE *export_fp = OpenExportFile(data_dir_path, "file_keys",
+            map_name + "__" + hash_name + "__" + key_name + "__uint64_t.csv");
+    if (export_fp == nullptr) {
+        bench_key_file = nullptr;
+        return;
+    }
+    using UniformUint64RNG = MaskedUint64RNG<UNIFORM>;
+    cpu_t::CpuTimer cpu_timer;
+    if (is_string_key) {
+#ifndef BENCH_ONLY_INT
+        auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, FileKeyRNG<std::string>,
+                UniformUint64RNG>(seed, key_size_array, cpu_timer);
+        ExportToCsv(export_fp, key_size_array, result_vec, hist_arr_vec, cpu_timer);
+#endif
+    }
+    else {
+#ifndef BENCH_ONLY_STRING
+        auto [result_vec, hist_arr_vec] = TestOnePairType<uint64_t, uint64_t, FileKeyRNG<uint64_t>,
+                UniformUint64RNG>(seed, key_size_array, cpu_timer);
+        ExportToCsv(export_fp, key_size_array, result_vec, hist_arr_vec, cpu_timer);
+#endif
+    }
+    bench_key_file = nullptr;
+}
+
+#ifndef BENCH_ONLY_INT
+
+// All the copies of the big string keys of one key size take at most this number of bytes,
+// so the memory stays bounded
+static constexpr size_t BIG_STRING_MAX_KEY_BYTES = 256ULL * 1024ULL * 1024ULL;
+// TestTablePerformance holds the keys in the source vector, the key set, the miss and the
+// 50% hit lookup vectors and the table at the same time, and the new keys of the erase
+// and insert test in a vector and a key set
+static constexpr size_t BIG_STRING_KEY_COPY_NUM = 5;
+static constexpr size_t BIG_STRING_ERASE_KEY_COPY_NUM = 2;
+
+/**
+ * Test the string keys longer than 64 bytes. The keys with fixed length have at most
+ * ceil[log2(n)] bits which may differ, spread over the whole string, so the hash and the
+ * comparison have to read all the bytes to tell them apart. The keys with random length
+ * are made of random printable chars.
+ */
+template<size_t max_len, bool fix_length>
+void TestBigString(size_t seed, const std::vector<size_t>& key_size_array, CpuTimer& cpu_timer,
+                   const std::string& data_dir_path) {
+    using BigStringRNG = StringRNG<max_len, fix_length ? SPLIT_MASK_BYTES : PRINTABLE_CHARS, fix_length>;
+    using UniformUint64RNG = MaskedUint64RNG<UNIFORM>;
+    // Half of the bytes for the keys of the table and the lookups, half for the new keys of
+    // the erase and insert test
+    const size_t max_erase_time = BIG_STRING_MAX_KEY_BYTES / 2U / (max_len * BIG_STRING_ERASE_KEY_COPY_NUM);
+    std::vector<size_t> big_key_size_array;
+    for (size_t key_size: key_size_array) {
+        if (key_size * max_len * BIG_STRING_KEY_COPY_NUM <= BIG_STRING_MAX_KEY_BYTES / 2U) {
+            big_key_size_array.push_back(key_size);
+        }
+    }
+    fprintf(stderr, "\nTest Big String with %s length %lu\n\n", fix_length ? "fixed" : "max", max_len);
+    std::string data_file_name = std::string(MAP_NAME) + "__" + HASH_NAME + "__"
+            + (fix_length ? "big_string_fix_" : "big_string_max_") + std::to_string(max_len)
+            + "__" + "uint64_t" + ".csv";
+    std::string export_file_path = data_dir_path + data_file_name;
+    FILE *export_fp = fopen(export_file_path.c_str(), "w");
+    if (export_fp == nullptr) {
+        fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                std::strerror(errno));
+        return;
+    }
+    auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, BigStringRNG, UniformUint64RNG>(
+            seed, big_key_size_array, cpu_timer, max_erase_time);
+    ExportToCsv(export_fp, big_key_size_array, result_vec, hist_arr_vec, cpu_timer);
+}
+
+// Test the big string keys with each length in max_lens
+template<bool fix_length, size_t... max_lens>
+void TestBigStrings(size_t seed, const std::vector<size_t>& key_size_array, CpuTimer& cpu_timer,
+                    const std::string& data_dir_path) {
+    (TestBigString<max_lens, fix_length>(seed, key_size_array, cpu_timer, data_dir_path), ...);
+}
+
+#endif
+
+void BenchTest(size_t seed, const char* data_dir) {
+//    TestRNG();
+    using UniformUint64RNG = MaskedUint64RNG<UNIFORM>;
+#ifndef BENCH_ONLY_STRING
+    using MaskHighBitsUint64RNG = MaskedUint64RNG<MASK_HIGH_BITS>;
+    using MaskLowBitsUint64RNG = MaskedUint64RNG<MASK_LOW_BITS>;
+    using MaskSplitBitsUint64RNG = MaskedUint64RNG<MASK_SPLIT_BITS>;
+
+#endif
+
+
+    std::string map_name = std::string(MAP_NAME);
+    std::string hash_name = std::string(HASH_NAME);
+    std::string data_dir_path = std::string(data_dir) + PathSeparator();
+
+    cpu_t::CpuTimer cpu_timer;
+
+#if BENCH_LATENCY
+    fprintf(stderr, "Cpu timer ns / per tick: %.10lf, overhead: %" PRId64 " ticks\n",
+            cpu_timer.ns_per_tick(), cpu_timer.overhead_ticks());
+#   ifdef USE_RAW_HISTOGRAM
+    fprintf(stderr, "Use raw histogram\n");
+#   else
+    fprintf(stderr, "Use Hdr histogram\n");
+#   endif
+#endif
+
+#ifdef ENABLE_THP_ALLOC
+#   if ENABLE_THP_ALLOC
+    fprintf(stderr, "Transparent Huge Page enabled\n");
+#   endif
+#endif
+
+    std::vector<size_t> key_size_array = DefaultKeySizeArray();
 
     fprintf(stderr, "\n------ Begin to test hash %s with map %s ---\n", HASH_NAME, MAP_NAME);
 
@@ -2015,24 +3106,10 @@ void BenchTest(size_t seed, const char* data_dir) {
 
 #ifndef BENCH_ONLY_STRING
     if (!IsStringOnlyHash(hash_name)) {
-        {
-            fprintf(stderr, "\nTest Mid split bits masked distributed uint64 key\n\n");
-            std::string data_file_name =
-                    map_name + "__" + hash_name + "__" + "mask_split_bits_uint64_t" + "__" +
-                    "uint64_t" +
-                    ".csv";
-            std::string export_file_path = data_dir_path + data_file_name;
-            FILE *export_fp = fopen(export_file_path.c_str(), "w");
-            if (export_fp == nullptr) {
-                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
-                        std::strerror(errno));
-                return;
-            }
-            auto [result_vec, hist_arr_vec] = TestOnePairType<uint64_t, uint64_t, MaskSplitBitsUint64RNG, UniformUint64RNG>(
-                    seed, key_size_array, cpu_timer);
-            ExportToCsv(export_fp, key_size_array, result_vec,
-                        hist_arr_vec, cpu_timer);
-        }
+        // The first one is the mid split bits masked uint64 key and uint64 value
+        TestWidthMatrix<std::pair<uint64_t, uint64_t>, std::pair<uint32_t, uint32_t>,
+                std::pair<uint32_t, uint64_t>, std::pair<uint64_t, uint32_t>>(
+                        seed, key_size_array, cpu_timer, data_dir_path);
 
         {
             fprintf(stderr, "\nTest Uniformly distributed uint64 key\n\n");
@@ -2090,11 +3167,11 @@ void BenchTest(size_t seed, const char* data_dir) {
         }
 
         {
-            fprintf(stderr,
-                    "\nTest mid split bits masked distributed uint64 key and 56 bytes payload\n\n");
+            using PatternUint64RNG = MaskedUint64RNG<SEQUENTIAL>;
+            fprintf(stderr, "\nTest Sequential uint64 key\n\n");
             std::string data_file_name =
-                    map_name + "__" + hash_name + "__" + "mask_split_bits_uint64_t" + "__" +
-                    "56bytes_payload" + ".csv";
+                    map_name + "__" + hash_name + "__" + "sequential_uint64_t" + "__" +
+                    "uint64_t" + ".csv";
             std::string export_file_path = data_dir_path + data_file_name;
             FILE *export_fp = fopen(export_file_path.c_str(), "w");
             if (export_fp == nullptr) {
@@ -2102,23 +3179,18 @@ void BenchTest(size_t seed, const char* data_dir) {
                         std::strerror(errno));
                 return;
             }
-            auto [result_vec, hist_arr_vec] = TestOnePairType<uint64_t, FixSizeStruct<56>, MaskSplitBitsUint64RNG, FixSizeStructRNG<56>>(
+            auto [result_vec, hist_arr_vec] = TestOnePairType<uint64_t, uint64_t, PatternUint64RNG, UniformUint64RNG>(
                     seed, key_size_array, cpu_timer);
             ExportToCsv(export_fp, key_size_array, result_vec,
                         hist_arr_vec, cpu_timer);
         }
-    }
 
-#endif
-
-#ifndef BENCH_ONLY_INT
-    {
         {
-            using MidStringRNG = StringRNG<64, PRINTABLE_CHARS, false>;
-            fprintf(stderr, "\nTest Long Random Len String with max length 64\n\n");
+            using PatternUint64RNG = MaskedUint64RNG<SEQUENTIAL_WITH_GAPS>;
+            fprintf(stderr, "\nTest Sequential with gaps uint64 key\n\n");
             std::string data_file_name =
-                    map_name + "__" + hash_name + "__" + "long_string_max_64" + "__" + "uint64_t" +
-                    ".csv";
+                    map_name + "__" + hash_name + "__" + "sequential_gaps_uint64_t" + "__" +
+                    "uint64_t" + ".csv";
             std::string export_file_path = data_dir_path + data_file_name;
             FILE *export_fp = fopen(export_file_path.c_str(), "w");
             if (export_fp == nullptr) {
@@ -2126,18 +3198,18 @@ void BenchTest(size_t seed, const char* data_dir) {
                         std::strerror(errno));
                 return;
             }
-            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, MidStringRNG, UniformUint64RNG>(
+            auto [result_vec, hist_arr_vec] = TestOnePairType<uint64_t, uint64_t, PatternUint64RNG, UniformUint64RNG>(
                     seed, key_size_array, cpu_timer);
             ExportToCsv(export_fp, key_size_array, result_vec,
                         hist_arr_vec, cpu_timer);
         }
 
         {
-            using MidStringRNG = StringRNG<64, SPLIT_MASK_BYTES, true>;
-            fprintf(stderr, "\nTest Long Len String with fixed length 64\n\n");
+            using PatternUint64RNG = MaskedUint64RNG<POINTER_LIKE>;
+            fprintf(stderr, "\nTest Pointer like uint64 key\n\n");
             std::string data_file_name =
-                    map_name + "__" + hash_name + "__" + "long_string_fix_64" + "__" + "uint64_t" +
-                    ".csv";
+                    map_name + "__" + hash_name + "__" + "pointer_like_uint64_t" + "__" +
+                    "uint64_t" + ".csv";
             std::string export_file_path = data_dir_path + data_file_name;
             FILE *export_fp = fopen(export_file_path.c_str(), "w");
             if (export_fp == nullptr) {
@@ -2145,18 +3217,18 @@ void BenchTest(size_t seed, const char* data_dir) {
                         std::strerror(errno));
                 return;
             }
-            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, MidStringRNG, UniformUint64RNG>(
+            auto [result_vec, hist_arr_vec] = TestOnePairType<uint64_t, uint64_t, PatternUint64RNG, UniformUint64RNG>(
                     seed, key_size_array, cpu_timer);
             ExportToCsv(export_fp, key_size_array, result_vec,
                         hist_arr_vec, cpu_timer);
         }
 
         {
-            fprintf(stderr, "\nTest Small Random Len String with max length 12\n\n");
-            using SmallStringRNG = StringRNG<12, PRINTABLE_CHARS, false>;
+            using PatternUint64RNG = MaskedUint64RNG<TIMESTAMPS>;
+            fprintf(stderr, "\nTest Timestamps with jitter uint64 key\n\n");
             std::string data_file_name =
-                    map_name + "__" + hash_name + "__" + "small_string_max_12" + "__" + "uint64_t" +
-                    ".csv";
+                    map_name + "__" + hash_name + "__" + "timestamp_uint64_t" + "__" +
+                    "uint64_t" + ".csv";
             std::string export_file_path = data_dir_path + data_file_name;
             FILE *export_fp = fopen(export_file_path.c_str(), "w");
             if (export_fp == nullptr) {
@@ -2164,18 +3236,18 @@ void BenchTest(size_t seed, const char* data_dir) {
                         std::strerror(errno));
                 return;
             }
-            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, SmallStringRNG, UniformUint64RNG>(
+            auto [result_vec, hist_arr_vec] = TestOnePairType<uint64_t, uint64_t, PatternUint64RNG, UniformUint64RNG>(
                     seed, key_size_array, cpu_timer);
             ExportToCsv(export_fp, key_size_array, result_vec,
                         hist_arr_vec, cpu_timer);
         }
 
         {
-            fprintf(stderr, "\nTest Small String with fixed length 12\n\n");
-            using SmallStringRNG = StringRNG<12, SPLIT_MASK_BYTES, true>;
+            using PatternUint64RNG = MaskedUint64RNG<ENTROPY_BITS, 16>;
+            fprintf(stderr, "\nTest uint64 key with 16 random split bits\n\n");
             std::string data_file_name =
-                    map_name + "__" + hash_name + "__" + "small_string_fix_12" + "__" + "uint64_t" +
-                    ".csv";
+                    map_name + "__" + hash_name + "__" + "entropy_16_bits_uint64_t" + "__" +
+                    "uint64_t" + ".csv";
             std::string export_file_path = data_dir_path + data_file_name;
             FILE *export_fp = fopen(export_file_path.c_str(), "w");
             if (export_fp == nullptr) {
@@ -2183,22 +3255,37 @@ void BenchTest(size_t seed, const char* data_dir) {
                         std::strerror(errno));
                 return;
             }
-            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, SmallStringRNG, UniformUint64RNG>(
+            auto [result_vec, hist_arr_vec] = TestOnePairType<uint64_t, uint64_t, PatternUint64RNG, UniformUint64RNG>(
                     seed, key_size_array, cpu_timer);
             ExportToCsv(export_fp, key_size_array, result_vec,
                         hist_arr_vec, cpu_timer);
         }
 
+        {
+            using PatternUint64RNG = MaskedUint64RNG<ENTROPY_BITS, 32>;
+            fprintf(stderr, "\nTest uint64 key with 32 random split bits\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "entropy_32_bits_uint64_t" + "__" +
+                    "uint64_t" + ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<uint64_t, uint64_t, PatternUint64RNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
 
         {
-            constexpr size_t TEST_LEN = 24;
-            using MidStringRNG = StringRNG<TEST_LEN, PRINTABLE_CHARS, false>;
-            fprintf(stderr, "\nTest Mid Random Len String with max length %zu\n\n",
-                    TEST_LEN);
+            using PatternUint64RNG = MaskedUint64RNG<ENTROPY_BITS, 48>;
+            fprintf(stderr, "\nTest uint64 key with 48 random split bits\n\n");
             std::string data_file_name =
-                    map_name + "__" + hash_name + "__" + "mid_string_max_" +
-                    std::to_string(TEST_LEN) + "__" + "uint64_t" +
-                    ".csv";
+                    map_name + "__" + hash_name + "__" + "entropy_48_bits_uint64_t" + "__" +
+                    "uint64_t" + ".csv";
             std::string export_file_path = data_dir_path + data_file_name;
             FILE *export_fp = fopen(export_file_path.c_str(), "w");
             if (export_fp == nullptr) {
@@ -2206,21 +3293,18 @@ void BenchTest(size_t seed, const char* data_dir) {
                         std::strerror(errno));
                 return;
             }
-            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, MidStringRNG, UniformUint64RNG>(
+            auto [result_vec, hist_arr_vec] = TestOnePairType<uint64_t, uint64_t, PatternUint64RNG, UniformUint64RNG>(
                     seed, key_size_array, cpu_timer);
             ExportToCsv(export_fp, key_size_array, result_vec,
                         hist_arr_vec, cpu_timer);
         }
 
         {
-            constexpr size_t TEST_LEN = 24;
-            using MidStringRNG = StringRNG<TEST_LEN, SPLIT_MASK_BYTES, true>;
-            fprintf(stderr, "\nTest Mid Len String with fixed length %zu\n\n",
-                    TEST_LEN);
+            using CompositeRNG = CompositeKeyRNG<std::pair<uint32_t, uint32_t>, MaskHighBitsUint64RNG, MaskHighBitsUint64RNG>;
+            fprintf(stderr, "\nTest pair of uint32 (tenant id, object id) key\n\n");
             std::string data_file_name =
-                    map_name + "__" + hash_name + "__" + "mid_string_fix_" +
-                    std::to_string(TEST_LEN) + "__" + "uint64_t" +
-                    ".csv";
+                    map_name + "__" + hash_name + "__" + "pair_uint32_t_uint32_t" + "__" +
+                    "uint64_t" + ".csv";
             std::string export_file_path = data_dir_path + data_file_name;
             FILE *export_fp = fopen(export_file_path.c_str(), "w");
             if (export_fp == nullptr) {
@@ -2228,65 +3312,2434 @@ void BenchTest(size_t seed, const char* data_dir) {
                         std::strerror(errno));
                 return;
             }
-            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, MidStringRNG, UniformUint64RNG>(
+            auto [result_vec, hist_arr_vec] = TestOnePairType<std::pair<uint32_t, uint32_t>, uint64_t, CompositeRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+        {
+            using CompositeRNG = CompositeKeyRNG<std::pair<uint64_t, uint64_t>, MaskSplitBitsUint64RNG, MaskSplitBitsUint64RNG>;
+            fprintf(stderr, "\nTest pair of mid split bits masked uint64 key\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "pair_uint64_t_uint64_t" + "__" +
+                    "uint64_t" + ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<std::pair<uint64_t, uint64_t>, uint64_t, CompositeRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+#ifdef __SIZEOF_INT128__
+        {
+            using CompositeRNG = CompositeKeyRNG<__uint128_t, MaskSplitBitsUint64RNG, MaskSplitBitsUint64RNG>;
+            fprintf(stderr, "\nTest mid split bits masked 128-bit key\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "uint128_t" + "__" +
+                    "uint64_t" + ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<__uint128_t, uint64_t, CompositeRNG, UniformUint64RNG>(
                     seed, key_size_array, cpu_timer);
             ExportToCsv(export_fp, key_size_array, result_vec,
                         hist_arr_vec, cpu_timer);
         }
+#endif
 
+        {
+            using CompositeRNG = CompositeKeyRNG<bench::Pod16Key, MaskHighBitsUint64RNG, MaskSplitBitsUint64RNG>;
+            fprintf(stderr, "\nTest 16 bytes POD (tenant id, shard id, object id) key\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "pod_16bytes" + "__" +
+                    "uint64_t" + ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<bench::Pod16Key, uint64_t, CompositeRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
 
+        {
+            fprintf(stderr,
+                    "\nTest mid split bits masked distributed uint64 key and 56 bytes payload\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "mask_split_bits_uint64_t" + "__" +
+                    "56bytes_payload" + ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<uint64_t, FixSizeStruct<56>, MaskSplitBitsUint64RNG, FixSizeStructRNG<56>>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
 
-//        {
-//            using BigStringRNG = StringRNG<128, SPLIT_MASK_BYTES, true>;
-//            fprintf(stderr, "\nTest Big String with fixed length 128\n\n");
-//            std::string data_file_name =
-//                    map_name + "__" + hash_name + "__" + "big_string_fix_128" + "__" + "uint64_t" +
-//                    ".csv";
-//            std::string export_file_path = data_dir_path + data_file_name;
-//            FILE *export_fp = fopen(export_file_path.c_str(), "w");
-//            if (export_fp == nullptr) {
-//                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
-//                        std::strerror(errno));
-//                return;
-//            }
-//            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, BigStringRNG, UniformUint64RNG>(
-//                    seed, key_size_array, cpu_timer);
-//            ExportToCsv(export_fp, key_size_array, result_vec,
-//                        hist_arr_vec, cpu_timer);
-//        }
-//
-//        {
-//            using BigStringRNG = StringRNG<128, SPLIT_MASK_BYTES, false>;
-//            fprintf(stderr, "\nTest Big String with max length 128\n\n");
-//            std::string data_file_name =
-//                    map_name + "__" + hash_name + "__" + "big_string_max_128" + "__" + "uint64_t" +
-//                    ".csv";
-//            std::string export_file_path = data_dir_path + data_file_name;
-//            FILE *export_fp = fopen(export_file_path.c_str(), "w");
-//            if (export_fp == nullptr) {
-//                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
-//                        std::strerror(errno));
-//                return;
-//            }
-//            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, BigStringRNG, UniformUint64RNG>(
-//                    seed, key_size_array, cpu_timer);
-//            ExportToCsv(export_fp, key_size_array, result_vec,
-//                        hist_arr_vec, cpu_timer);
-//        }
+        {
+            fprintf(stderr,
+                    "\nTest mid split bits masked distributed uint64 key and short string value with max length 12\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "mask_split_bits_uint64_t" + "__" +
+                    "short_string_max_12" + ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<uint64_t, HeapString, MaskSplitBitsUint64RNG, HeapValueRNG<HeapString, 12>>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+        {
+            fprintf(stderr,
+                    "\nTest mid split bits masked distributed uint64 key and long string value with max length 64\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "mask_split_bits_uint64_t" + "__" +
+                    "long_string_max_64" + ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<uint64_t, HeapString, MaskSplitBitsUint64RNG, HeapValueRNG<HeapString, 64>>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+        {
+            fprintf(stderr,
+                    "\nTest mid split bits masked distributed uint64 key and uint32 vector value with max length 16\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "mask_split_bits_uint64_t" + "__" +
+                    "vector_uint32_t_max_16" + ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<uint64_t, HeapUint32Vec, MaskSplitBitsUint64RNG, HeapValueRNG<HeapUint32Vec, 16>>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+        {
+            fprintf(stderr,
+                    "\nTest mid split bits masked distributed uint64 key and value with a throwing move constructor\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "mask_split_bits_uint64_t" + "__" +
+                    "throwing_move_vector_max_8" + ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<uint64_t, ThrowingMoveValue, MaskSplitBitsUint64RNG, HeapValueRNG<ThrowingMoveValue, 8>>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+        TestAdversarialKeys<uint64_t>(seed, key_size_array, cpu_timer, data_dir_path, "uint64_t");
     }
+
 #endif
 
+#ifndef BENCH_ONLY_INT
+    {
+        {
+            using MidStringRNG = StringRNG<64, PRINTABLE_CHARS, false>;
+            fprintf(stderr, "\nTest Long Random Len String with max length 64\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "long_string_max_64" + "__" + "uint64_t" +
+                    ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, MidStringRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
 
+        {
+            using MidStringRNG = StringRNG<64, SPLIT_MASK_BYTES, true>;
+            fprintf(stderr, "\nTest Long Len String with fixed length 64\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "long_string_fix_64" + "__" + "uint64_t" +
+                    ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, MidStringRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
 
+        {
+            using FixedKey = bench::FixedString<64>;
+            using MidStringRNG = FixedStringRNG<64>;
+            fprintf(stderr, "\nTest Long Len Fixed String with fixed length 64 stored inline\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "long_fixed_string_64" + "__" + "uint64_t" +
+                    ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<FixedKey, uint64_t, MidStringRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
 
-}
+        {
+            fprintf(stderr, "\nTest Small Random Len String with max length 12\n\n");
+            using SmallStringRNG = StringRNG<12, PRINTABLE_CHARS, false>;
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "small_string_max_12" + "__" + "uint64_t" +
+                    ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, SmallStringRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+        {
+            fprintf(stderr, "\nTest Small String with fixed length 12\n\n");
+            using SmallStringRNG = StringRNG<12, SPLIT_MASK_BYTES, true>;
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "small_string_fix_12" + "__" + "uint64_t" +
+                    ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, SmallStringRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+        {
+            using FixedKey = bench::FixedString<12>;
+            using SmallStringRNG = FixedStringRNG<12>;
+            fprintf(stderr, "\nTest Small Fixed String with fixed length 12 stored inline\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "small_fixed_string_12" + "__" + "uint64_t" +
+                    ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<FixedKey, uint64_t, SmallStringRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+
+        {
+            constexpr size_t TEST_LEN = 24;
+            using MidStringRNG = StringRNG<TEST_LEN, PRINTABLE_CHARS, false>;
+            fprintf(stderr, "\nTest Mid Random Len String with max length %zu\n\n",
+                    TEST_LEN);
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "mid_string_max_" +
+                    std::to_string(TEST_LEN) + "__" + "uint64_t" +
+                    ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, MidStringRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+        {
+            constexpr size_t TEST_LEN = 24;
+            using MidStringRNG = StringRNG<TEST_LEN, SPLIT_MASK_BYTES, true>;
+            fprintf(stderr, "\nTest Mid Len String with fixed length %zu\n\n",
+                    TEST_LEN);
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "mid_string_fix_" +
+                    std::to_string(TEST_LEN) + "__" + "uint64_t" +
+                    ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, MidStringRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+        {
+            using FixedKey = bench::FixedString<24>;
+            using MidStringRNG = FixedStringRNG<24>;
+            fprintf(stderr, "\nTest Mid Len Fixed String with fixed length 24 stored inline\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "mid_fixed_string_24" + "__" + "uint64_t" +
+                    ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<FixedKey, uint64_t, MidStringRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+
+
+        {
+            using RealisticStringRNG = StringRNG<128, URL_PATHS, false>;
+            fprintf(stderr, "\nTest Url and path string\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "url_string" + "__" + "uint64_t" +
+                    ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, RealisticStringRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+        {
+            using RealisticStringRNG = StringRNG<36, UUIDS, false>;
+            fprintf(stderr, "\nTest Uuid string\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "uuid_string" + "__" + "uint64_t" +
+                    ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, RealisticStringRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+        {
+            using RealisticStringRNG = StringRNG<40, IP_ADDRESSES, false>;
+            fprintf(stderr, "\nTest IPv4 and IPv6 address string\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "ip_string" + "__" + "uint64_t" +
+                    ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, RealisticStringRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+        {
+            using RealisticStringRNG = StringRNG<20, DECIMAL_IDS, false>;
+            fprintf(stderr, "\nTest Decimal formatted 64-bit id string\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "decimal_id_string" + "__" + "uint64_t" +
+                    ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, RealisticStringRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+        {
+            using RealisticStringRNG = StringRNG<128, LOG_NORMAL_LENGTH, false>;
+            fprintf(stderr, "\nTest Log-normal distributed length string with max length 128\n\n");
+            std::string data_file_name =
+                    map_name + "__" + hash_name + "__" + "log_normal_string_max_128" + "__" + "uint64_t" +
+                    ".csv";
+            std::string export_file_path = data_dir_path + data_file_name;
+            FILE *export_fp = fopen(export_file_path.c_str(), "w");
+            if (export_fp == nullptr) {
+                fprintf(stderr, "Error when create file at %s\n%s", export_file_path.c_str(),
+                        std::strerror(errno));
+                return;
+            }
+            auto [result_vec, hist_arr_vec] = TestOnePairType<std::string, uint64_t, RealisticStringRNG, UniformUint64RNG>(
+                    seed, key_size_array, cpu_timer);
+            ExportToCsv(export_fp, key_size_array, result_vec,
+                        hist_arr_vec, cpu_timer);
+        }
+
+
+        TestBigStrings<true, 128, 256, 512, 1024>(seed, key_size_array, cpu_timer, data_dir_path);
+        TestBigStrings<false, 128, 256, 512, 1024>(seed, key_size_array, cpu_timer, data_dir_path);
+
+        TestAdversarialKeys<std::string>(seed, key_size_array, cpu_timer, data_dir_path, "string");
+    }
+#endif
+
+
+
+
+}
+
+#ifdef BENCH_MEMORY_BUDGET
+
+#ifndef USE_COUNT_ALLOC
+#error "BENCH_MEMORY_BUDGET requires the count_allocator"
+#endif
+
+// The memory budgets (MB) to test, can be set by cmake
+#ifndef MEMORY_BUDGET_MB_LIST
+#define MEMORY_BUDGET_MB_LIST 1, 4, 16, 64
+#endif
+
+static const char* MEMORY_BUDGET_CSV_HEADER = "budget_mb,max_element_num,final_size_mb,peak_size_mb,"
+                                              "load_factor,avg_hit_lookup_ns,avg_miss_lookup_ns";
+using MemoryBudgetStats = std::array<double, 7>;
+
+/**
+ * Find the largest number of elements that can be inserted (without reserve,
+ * so the peak memory during rehash is included) into the table when the heap
+ * memory used by the table is limited to each budget, then measure the lookup
+ * time of the table with that number of elements.
+ */
+template<class KeyType, class ValueType, class KeyRandomGen, class ValueRandomGen>
+std::vector<MemoryBudgetStats> TestMemoryBudget(size_t seed, const std::vector<size_t>& budget_mb_vec) {
+    using RandomGenerator = RandomPairGen<KeyType, ValueType, KeyRandomGen, ValueRandomGen>;
+    using PairType = std::pair<KeyType, ValueType>;
+    using Table = Map<KeyType, ValueType>;
+    using GetKey = SimpleGetKey<PairType>;
+
+    constexpr uint64_t timeout_threshold_ns_per_insert = 20'000ULL; // 20 us
+    constexpr size_t LOOKUP_TIME = 10'000'000ULL;
+
+    auto& mem_count = count::MemoryCount::instance();
+    std::vector<MemoryBudgetStats> result_vec(budget_mb_vec.size(), MemoryBudgetStats{0});
+    if (budget_mb_vec.empty()) {
+        return result_vec;
+    }
+    std::mt19937_64 random_engine(seed);
+
+    // A table can never hold more elements than this in the largest budget
+    size_t max_budget_mb = *std::max_element(budget_mb_vec.begin(), budget_mb_vec.end());
+    size_t max_possible_num = max_budget_mb * 1024ULL * 1024ULL / sizeof(PairType) + 1ULL;
+    KeySet<KeyType> key_set;
+    auto src_vec = GenUniqueValueVec<RandomGenerator, KeyType, ValueType, PairType>(
+            max_possible_num, max_possible_num, random_engine(), key_set);
+    auto miss_vec = GenUniqueValueVec<RandomGenerator, KeyType, ValueType, PairType>(
+            max_possible_num, max_possible_num * 4ULL, random_engine(), key_set);
+    key_set = {};
+
+    {
+        size_t start_bytes = mem_count.cur_bytes();
+        Table table;
+        for (size_t i = 0; i < std::min(src_vec.size(), size_t(1024)); ++i) {
+            table.emplace(src_vec[i]);
+        }
+        if (mem_count.cur_bytes() == start_bytes) {
+            fprintf(stderr, "%s does not allocate with the count allocator, "
+                            "skip memory budget test\n", MAP_NAME);
+            return result_vec;
+        }
+    }
+
+    bool timeout_flag = false;
+    // Return whether element_num elements can be inserted within budget_bytes
+    auto fit_in_budget = [&](size_t element_num, size_t budget_bytes) {
+        bool fit = true;
+        mem_count.SetBytesLimit(mem_count.cur_bytes() + budget_bytes);
+        auto start_t = std::chrono::high_resolution_clock::now();
+        try {
+            Table table;
+            for (size_t i = 0; i < element_num; ++i) {
+                table.emplace(src_vec[i]);
+            }
+        } catch (std::bad_alloc&) {
+            fit = false;
+        } catch (std::exception &e) {
+            fprintf(stderr, "Catch exception when test memory budget, element_num: %lu\n%s\n",
+                    element_num, e.what());
+            fit = false;
+        }
+        mem_count.SetBytesLimit(0);
+        auto end_t = std::chrono::high_resolution_clock::now();
+        auto pass_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count();
+        if (uint64_t(pass_ns) > timeout_threshold_ns_per_insert * std::max(element_num, size_t(1))) {
+            fprintf(stderr, "Timeout in test memory budget, avg %.3f ns per insert\n",
+                    double(pass_ns) / double(std::max(element_num, size_t(1))));
+            timeout_flag = true;
+        }
+        return fit;
+    };
+
+    for (size_t k = 0; k < budget_mb_vec.size() && !timeout_flag; ++k) {
+        size_t budget_mb = budget_mb_vec[k];
+        size_t budget_bytes = budget_mb * 1024ULL * 1024ULL;
+        size_t upper_num = std::min(src_vec.size(), size_t(budget_bytes / sizeof(PairType) + 1UL));
+
+        // Exponential search then binary search, fit_num always fits and
+        // not_fit_num never fits
+        size_t fit_num = 0, not_fit_num = upper_num + 1ULL;
+        for (size_t try_num = 1024; !timeout_flag; try_num *= 2ULL) {
+            try_num = std::min(try_num, upper_num);
+            if (!fit_in_budget(try_num, budget_bytes)) {
+                not_fit_num = try_num;
+                break;
+            }
+            fit_num = try_num;
+            if (try_num == upper_num) {
+                break;
+            }
+        }
+        while (fit_num + 1ULL < not_fit_num && !timeout_flag) {
+            size_t mid_num = fit_num + (not_fit_num - fit_num) / 2ULL;
+            if (fit_in_budget(mid_num, budget_bytes)) {
+                fit_num = mid_num;
+            }
+            else {
+                not_fit_num = mid_num;
+            }
+        }
+        if (timeout_flag || fit_num == 0) {
+            break;
+        }
+
+        Table table;
+        mem_count.ResetPeakBytes();
+        size_t start_bytes = mem_count.cur_bytes();
+        mem_count.SetBytesLimit(start_bytes + budget_bytes);
+        for (size_t i = 0; i < fit_num; ++i) {
+            table.emplace(src_vec[i]);
+        }
+        mem_count.SetBytesLimit(0);
+        double final_size_mb = double(mem_count.cur_bytes() - start_bytes) / (1024.0 * 1024.0);
+        double peak_size_mb = double(mem_count.peak_bytes() - start_bytes) / (1024.0 * 1024.0);
+        float load_factor = table.load_factor();
+
+        std::vector<typename MutableValue<PairType>::type> hit_vec(src_vec.begin(),
+                                                                   src_vec.begin() + fit_num);
+        std::shuffle(hit_vec.begin(), hit_vec.end(), random_engine);
+        uint64_t hit_lookup_ns = TimeTableFind<Table, decltype(hit_vec), GetKey>(
+                table, LOOKUP_TIME, hit_vec);
+        uint64_t miss_lookup_ns = TimeTableFind<Table, decltype(miss_vec), GetKey>(
+                table, LOOKUP_TIME, miss_vec);
+
+        fprintf(stderr, "%s with %s, memory budget %lu MB, max %lu elements, final use %.3f MB, "
+                        "peak use %.3f MB, load_factor: %.3f, find hit use %.3f ns, "
+                        "find miss use %.3f ns\n",
+                MAP_NAME, HASH_NAME, budget_mb, fit_num, final_size_mb, peak_size_mb, load_factor,
+                double(hit_lookup_ns) / double(LOOKUP_TIME),
+                double(miss_lookup_ns) / double(LOOKUP_TIME));
+        result_vec[k] = {double(budget_mb), double(fit_num), final_size_mb, peak_size_mb,
+                         load_factor, double(hit_lookup_ns) / double(LOOKUP_TIME),
+                         double(miss_lookup_ns) / double(LOOKUP_TIME)};
+    }
+    return result_vec;
+}
+
+void BenchMemoryBudget(size_t seed, const char* data_dir) {
+    std::string map_name = std::string(MAP_NAME);
+    std::string hash_name = std::string(HASH_NAME);
+    std::string data_dir_path = std::string(data_dir) + PathSeparator();
+    std::vector<size_t> budget_mb_vec = {MEMORY_BUDGET_MB_LIST};
+
+    fprintf(stderr, "\n------ Begin to test memory budget of hash %s with map %s ---\n",
+            HASH_NAME, MAP_NAME);
+
+#ifndef BENCH_ONLY_STRING
+    if (!IsStringOnlyHash(hash_name)) {
+        using UniformUint64RNG = MaskedUint64RNG<UNIFORM>;
+        using MaskSplitBitsUint64RNG = MaskedUint64RNG<MASK_SPLIT_BITS>;
+        {
+            fprintf(stderr, "\nTest memory budget with mid split bits masked uint64 key\n\n");
+            FILE *export_fp = OpenExportFile(data_dir_path, "memory_budget",
+                    map_name + "__" + hash_name + "__mask_split_bits_uint64_t__uint64_t.csv");
+            if (export_fp == nullptr) {
+                return;
+            }
+            ExportRowsToCsv(export_fp, MEMORY_BUDGET_CSV_HEADER, TestMemoryBudget<uint64_t, uint64_t,
+                    MaskSplitBitsUint64RNG, UniformUint64RNG>(seed, budget_mb_vec));
+        }
+        {
+            fprintf(stderr, "\nTest memory budget with mid split bits masked uint64 key "
+                            "and 56 bytes payload\n\n");
+            FILE *export_fp = OpenExportFile(data_dir_path, "memory_budget",
+                    map_name + "__" + hash_name + "__mask_split_bits_uint64_t__56bytes_payload.csv");
+            if (export_fp == nullptr) {
+                return;
+            }
+            ExportRowsToCsv(export_fp, MEMORY_BUDGET_CSV_HEADER, TestMemoryBudget<uint64_t, FixSizeStruct<56>,
+                    MaskSplitBitsUint64RNG, FixSizeStructRNG<56>>(seed, budget_mb_vec));
+        }
+    }
+#endif
+
+#ifndef BENCH_ONLY_INT
+    {
+        using UniformUint64RNG = MaskedUint64RNG<UNIFORM>;
+        using MidStringRNG = StringRNG<24, PRINTABLE_CHARS, false>;
+        fprintf(stderr, "\nTest memory budget with mid random len string with max length 24\n\n");
+        FILE *export_fp = OpenExportFile(data_dir_path, "memory_budget",
+                map_name + "__" + hash_name + "__mid_string_max_24__uint64_t.csv");
+        if (export_fp == nullptr) {
+            return;
+        }
+        ExportRowsToCsv(export_fp, MEMORY_BUDGET_CSV_HEADER, TestMemoryBudget<std::string, uint64_t,
+                MidStringRNG, UniformUint64RNG>(seed, budget_mb_vec));
+    }
+#endif
+}
+
+#endif // BENCH_MEMORY_BUDGET
+
+#ifdef BENCH_MOVE_ENTRIES
+
+// The percentages of the entries moved from one table to another
+static constexpr std::array<size_t, 3> MOVE_PERCENT_ARR = {10, 50, 100};
+
+// Move the entries with the keys in key_vec from src_table to dst_table
+template<class Table, class KeyVec>
+void MoveTableEntries(Table& src_table, Table& dst_table, const KeyVec& key_vec) {
+    for (const auto& key: key_vec) {
+        if constexpr (detail::has_node_handle<Table>::value) {
+            dst_table.insert(src_table.extract(key));
+        }
+        else {
+            auto find_it = src_table.find(key);
+            dst_table.emplace(find_it->first, std::move(find_it->second));
+            src_table.erase(find_it);
+        }
+    }
+}
+
+// Move all the entries of src_table into dst_table, the keys of the two tables are disjoint
+template<class Table>
+void MergeTable(Table& dst_table, Table& src_table) {
+    if constexpr (detail::has_merge<Table>::value) {
+        dst_table.merge(src_table);
+    }
+    else {
+        for (auto it = src_table.begin(); it != src_table.end(); ++it) {
+            dst_table.emplace(it->first, std::move(it->second));
+        }
+        src_table.clear();
+    }
+}
+
+std::string MoveEntriesCsvHeader() {
+    std::string csv_header = "element_num,use_node_handle,use_merge";
+    std::vector<std::string> item_vec;
+    for (auto move_percent: MOVE_PERCENT_ARR) {
+        item_vec.push_back("move_" + std::to_string(move_percent) + "%");
+    }
+    item_vec.emplace_back("merge");
+    for (const auto& item: item_vec) {
+        csv_header += "," + item + "_ns_per_element";
+#ifdef USE_COUNT_ALLOC
+        csv_header += "," + item + "_alloc_calls_per_element," + item + "_dealloc_calls_per_element";
+#endif
+    }
+    return csv_header;
+}
+
+/**
+ * Test moving part of the entries from one table to another table which has
+ * the same number of other entries, and merging two tables. Node handles
+ * (extract and insert) and merge() are used when the map supports them,
+ * otherwise the entries are moved with find, emplace and erase.
+ * The columns are the same as MoveEntriesCsvHeader()
+ */
+template<class KeyType, class ValueType, class KeyRandomGen, class ValueRandomGen>
+std::vector<std::vector<double>> TestMoveEntries(size_t seed, const std::vector<size_t>& element_num_vec) {
+    using RandomGenerator = RandomPairGen<KeyType, ValueType, KeyRandomGen, ValueRandomGen>;
+    using PairType = std::pair<KeyType, ValueType>;
+    using Table = Map<KeyType, ValueType>;
+    using PairVec = std::vector<typename MutableValue<PairType>::type>;
+
+    constexpr uint64_t timeout_threshold_ns_per_move = 20'000ULL; // 20 us
+    constexpr size_t TOTAL_MOVE_ELEMENT_NUM = 2'000'000ULL;
+#ifdef USE_COUNT_ALLOC
+    constexpr size_t COLUMN_NUM_PER_ITEM = 3;
+#else
+    constexpr size_t COLUMN_NUM_PER_ITEM = 1;
+#endif
+    constexpr size_t ROW_SIZE = 3 + (MOVE_PERCENT_ARR.size() + 1) * COLUMN_NUM_PER_ITEM;
+
+    std::mt19937_64 random_engine(seed);
+    std::vector<std::vector<double>> result_vec;
+    bool already_time_out_flag = false;
+    for (size_t element_num: element_num_vec) {
+        std::vector<double> row = {double(element_num), double(detail::has_node_handle<Table>::value),
+                                   double(detail::has_merge<Table>::value)};
+        if (already_time_out_flag) {
+            row.resize(ROW_SIZE, 0.0);
+            result_vec.push_back(std::move(row));
+            continue;
+        }
+        KeySet<KeyType> key_set;
+        PairVec src_vec = GenUniqueValueVec<RandomGenerator, KeyType, ValueType, PairType>(
+                element_num, element_num, random_engine(), key_set);
+        PairVec dst_vec = GenUniqueValueVec<RandomGenerator, KeyType, ValueType, PairType>(
+                element_num, element_num * 4ULL, random_engine(), key_set);
+        key_set = {};
+        size_t repeat_time = std::max(size_t(1), TOTAL_MOVE_ELEMENT_NUM / element_num);
+
+        // Call func(src_table, dst_table) repeat_time times with new tables, and
+        // add ns (and allocate, deallocate calls) per moved element to the row
+        auto time_move = [&](size_t moved_num, auto&& func) {
+            uint64_t total_ns = 0;
+            size_t alloc_calls = 0, dealloc_calls = 0;
+            for (size_t r = 0; r < repeat_time; ++r) {
+                Table src_table, dst_table;
+                ConstructTable(src_table, src_vec);
+                ConstructTable(dst_table, dst_vec);
+#ifdef USE_COUNT_ALLOC
+                size_t start_alloc_calls = count::MemoryCount::instance().alloc_calls();
+                size_t start_dealloc_calls = count::MemoryCount::instance().dealloc_calls();
+#endif
+                auto start_t = std::chrono::high_resolution_clock::now();
+                func(src_table, dst_table);
+                auto end_t = std::chrono::high_resolution_clock::now();
+#ifdef USE_COUNT_ALLOC
+                alloc_calls += count::MemoryCount::instance().alloc_calls() - start_alloc_calls;
+                dealloc_calls += count::MemoryCount::instance().dealloc_calls() - start_dealloc_calls;
+#endif
+                total_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count();
+                if (dst_table.size() != element_num + moved_num) {
+                    fprintf(stderr, "%s with %s has %lu elements after move, expect %lu\n",
+                            MAP_NAME, HASH_NAME, dst_table.size(), element_num + moved_num);
+                }
+                if (total_ns > timeout_threshold_ns_per_move * moved_num * (r + 1ULL)) {
+                    fprintf(stderr, "Timeout in test move entries, avg %.3f ns per element\n",
+                            double(total_ns) / double(moved_num * (r + 1ULL)));
+                    already_time_out_flag = true;
+                    total_ns = alloc_calls = dealloc_calls = 0;
+                    break;
+                }
+            }
+            double total_moved_num = double(moved_num * repeat_time);
+            row.push_back(double(total_ns) / total_moved_num);
+#ifdef USE_COUNT_ALLOC
+            row.push_back(double(alloc_calls) / total_moved_num);
+            row.push_back(double(dealloc_calls) / total_moved_num);
+#endif
+        };
+
+        try {
+            for (size_t move_percent: MOVE_PERCENT_ARR) {
+                // The larger moves of a timed out size would also time out, leave them 0
+                if (already_time_out_flag) {
+                    break;
+                }
+                size_t moved_num = std::max(size_t(1), element_num * move_percent / 100UL);
+                std::vector<KeyType> move_key_vec;
+                move_key_vec.reserve(element_num);
+                for (const auto& pair: src_vec) {
+                    move_key_vec.push_back(pair.first);
+                }
+                std::shuffle(move_key_vec.begin(), move_key_vec.end(), random_engine);
+                move_key_vec.resize(moved_num);
+                time_move(moved_num, [&](Table& src_table, Table& dst_table) {
+                    MoveTableEntries(src_table, dst_table, move_key_vec);
+                });
+            }
+            if (!already_time_out_flag) {
+                time_move(element_num, [](Table& src_table, Table& dst_table) {
+                    MergeTable(dst_table, src_table);
+                });
+            }
+        } catch(std::exception &e) {
+            fprintf(stderr, "Catch exception when test move entries, element_num: %lu\n%s\n",
+                    element_num, e.what());
+            row.resize(3);
+        }
+        row.resize(ROW_SIZE, 0.0);
+        fprintf(stderr, "%s with %s, %lu elements, use node handle: %d, use merge: %d, "
+                        "move %zu%% use %.3f ns per element, merge use %.3f ns per element\n",
+                MAP_NAME, HASH_NAME, element_num, int(row[1]), int(row[2]),
+                MOVE_PERCENT_ARR[0], row[3],
+                row[3 + MOVE_PERCENT_ARR.size() * COLUMN_NUM_PER_ITEM]);
+        result_vec.push_back(std::move(row));
+    }
+    return result_vec;
+}
+
+void BenchMoveEntries(size_t seed, const char* data_dir) {
+    std::string map_name = std::string(MAP_NAME);
+    std::string hash_name = std::string(HASH_NAME);
+    std::string data_dir_path = std::string(data_dir) + PathSeparator();
+    std::vector<size_t> element_num_vec = {1'000UL, 10'000UL, 100'000UL, 1'000'000UL};
+    std::string csv_header = MoveEntriesCsvHeader();
+
+    fprintf(stderr, "\n------ Begin to test moving entries of hash %s with map %s ---\n",
+            HASH_NAME, MAP_NAME);
+
+#ifndef BENCH_ONLY_STRING
+    if (!IsStringOnlyHash(hash_name)) {
+        using UniformUint64RNG = MaskedUint64RNG<UNIFORM>;
+        using MaskSplitBitsUint64RNG = MaskedUint64RNG<MASK_SPLIT_BITS>;
+        {
+            fprintf(stderr, "\nTest moving entries with mid split bits masked uint64 key\n\n");
+            FILE *export_fp = OpenExportFile(data_dir_path, "move_entries",
+                    map_name + "__" + hash_name + "__mask_split_bits_uint64_t__uint64_t.csv");
+            if (export_fp == nullptr) {
+                return;
+            }
+            ExportRowsToCsv(export_fp, csv_header, TestMoveEntries<uint64_t, uint64_t,
+                    MaskSplitBitsUint64RNG, UniformUint64RNG>(seed, element_num_vec));
+        }
+        {
+            fprintf(stderr, "\nTest moving entries with mid split bits masked uint64 key "
+                            "and 56 bytes payload\n\n");
+            FILE *export_fp = OpenExportFile(data_dir_path, "move_entries",
+                    map_name + "__" + hash_name + "__mask_split_bits_uint64_t__56bytes_payload.csv");
+            if (export_fp == nullptr) {
+                return;
+            }
+            ExportRowsToCsv(export_fp, csv_header, TestMoveEntries<uint64_t, FixSizeStruct<56>,
+                    MaskSplitBitsUint64RNG, FixSizeStructRNG<56>>(seed, element_num_vec));
+        }
+    }
+#endif
+
+#ifndef BENCH_ONLY_INT
+    {
+        using UniformUint64RNG = MaskedUint64RNG<UNIFORM>;
+        using MidStringRNG = StringRNG<24, PRINTABLE_CHARS, false>;
+        fprintf(stderr, "\nTest moving entries with mid random len string with max length 24\n\n");
+        FILE *export_fp = OpenExportFile(data_dir_path, "move_entries",
+                map_name + "__" + hash_name + "__mid_string_max_24__uint64_t.csv");
+        if (export_fp == nullptr) {
+            return;
+        }
+        ExportRowsToCsv(export_fp, csv_header, TestMoveEntries<std::string, uint64_t,
+                MidStringRNG, UniformUint64RNG>(seed, element_num_vec));
+    }
+#endif
+}
+
+#endif // BENCH_MOVE_ENTRIES
+
+#ifdef BENCH_ITERATE_VARIANTS
+
+static const char* ITERATE_VARIANTS_CSV_HEADER = "element_num,avg_iterate_one_byte_ns,avg_iterate_full_pair_ns,"
+                                                 "avg_iterate_erase_10%_ns,avg_iterate_after_90%_erase_ns,"
+                                                 "avg_iterate_and_probe_ns";
+using IterateVariantsStats = std::array<double, 6>;
+
+/**
+ * Test the variants of iteration, all in ns per element iterated:
+ * 1. read one byte of the mapped value, the same as TestTableIterate
+ * 2. read all bytes of the key and the mapped value
+ * 3. erase one of every 10 elements during the iteration
+ * 4. iterate the table after 90% of the elements are erased, the table is sparse
+ * 5. look up each iterated key in another table which contains 50% of the keys
+ */
+template<class KeyType, class ValueType, class KeyRandomGen, class ValueRandomGen>
+std::vector<IterateVariantsStats> TestIterateVariants(size_t seed, const std::vector<size_t>& element_num_vec) {
+    using RandomGenerator = RandomPairGen<KeyType, ValueType, KeyRandomGen, ValueRandomGen>;
+    using PairType = std::pair<KeyType, ValueType>;
+    using Table = Map<KeyType, ValueType>;
+    using PairVec = std::vector<typename MutableValue<PairType>::type>;
+
+    constexpr uint64_t timeout_threshold_ns_per_insert = 20'000ULL; // 20 us
+    constexpr size_t TOTAL_ITERATE_ELEMENT_NUM = 20'000'000ULL;
+
+    std::mt19937_64 random_engine(seed);
+    std::vector<IterateVariantsStats> result_vec;
+    bool already_time_out_flag = false;
+    uint64_t useless_sum = 0;
+    for (size_t element_num: element_num_vec) {
+        if (already_time_out_flag) {
+            result_vec.push_back(IterateVariantsStats{double(element_num)});
+            continue;
+        }
+        KeySet<KeyType> key_set;
+        PairVec src_vec = GenUniqueValueVec<RandomGenerator, KeyType, ValueType, PairType>(
+                element_num, element_num, random_engine(), key_set);
+        PairVec other_vec = GenUniqueValueVec<RandomGenerator, KeyType, ValueType, PairType>(
+                element_num - element_num / 2UL, element_num * 4ULL, random_engine(), key_set);
+        key_set = {};
+        // the table to probe has half of the keys in src_vec
+        std::shuffle(src_vec.begin(), src_vec.end(), random_engine);
+        other_vec.insert(other_vec.end(), src_vec.begin(), src_vec.begin() + element_num / 2UL);
+        std::shuffle(src_vec.begin(), src_vec.end(), random_engine);
+        const size_t iterate_time = std::max(size_t(1), TOTAL_ITERATE_ELEMENT_NUM / element_num);
+        IterateVariantsStats stats{double(element_num)};
+
+        // construct the table and check timeout
+        auto construct_table = [&](Table& table, const PairVec& pair_vec) {
+            auto start_t = std::chrono::high_resolution_clock::now();
+            ConstructTable(table, pair_vec);
+            auto end_t = std::chrono::high_resolution_clock::now();
+            uint64_t pass_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count();
+            if (pass_ns > timeout_threshold_ns_per_insert * pair_vec.size()) {
+                fprintf(stderr, "Timeout in construct when test iterate variants, avg %.3f ns per insert\n",
+                        double(pass_ns) / double(pair_vec.size()));
+                already_time_out_flag = true;
+            }
+            return !already_time_out_flag;
+        };
+
+        try {
+            Table table;
+            if (!construct_table(table, src_vec)) {
+                result_vec.push_back(stats);
+                continue;
+            }
+            auto start_t = std::chrono::high_resolution_clock::now();
+            for (size_t t = 0; t < iterate_time; ++t) {
+                for (auto it = table.begin(); it != table.end(); ++it) {
+                    useless_sum += *reinterpret_cast<const uint8_t*>(std::addressof(it->second));
+                }
+            }
+            auto end_t = std::chrono::high_resolution_clock::now();
+            stats[1] = double(std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count())
+                    / double(iterate_time * element_num);
+
+            start_t = std::chrono::high_resolution_clock::now();
+            for (size_t t = 0; t < iterate_time; ++t) {
+                for (auto it = table.begin(); it != table.end(); ++it) {
+                    useless_sum += ReadAllBytes(it->first) + ReadAllBytes(it->second);
+                }
+            }
+            end_t = std::chrono::high_resolution_clock::now();
+            stats[2] = double(std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count())
+                    / double(iterate_time * element_num);
+
+            Table probe_table;
+            if (!construct_table(probe_table, other_vec)) {
+                result_vec.push_back(IterateVariantsStats{double(element_num)});
+                continue;
+            }
+            start_t = std::chrono::high_resolution_clock::now();
+            for (size_t t = 0; t < iterate_time; ++t) {
+                for (auto it = table.begin(); it != table.end(); ++it) {
+                    useless_sum += probe_table.find(it->first) != probe_table.end();
+                }
+            }
+            end_t = std::chrono::high_resolution_clock::now();
+            stats[5] = double(std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count())
+                    / double(iterate_time * element_num);
+
+            // The table has to be constructed again for each time of erase
+            uint64_t erase_iterate_ns = 0;
+            size_t erase_iterate_cnt = 0;
+            for (size_t t = 0; t < iterate_time; ++t) {
+                Table erase_table;
+                if (!construct_table(erase_table, src_vec)) {
+                    break;
+                }
+                size_t visit_cnt = 0;
+                start_t = std::chrono::high_resolution_clock::now();
+                for (auto it = erase_table.begin(); it != erase_table.end();) {
+                    useless_sum += *reinterpret_cast<const uint8_t*>(std::addressof(it->second));
+                    if (visit_cnt++ % 10UL == 0) {
+                        if constexpr (detail::erase_returns_iterator<Table>::value) {
+                            it = erase_table.erase(it);
+                        }
+                        else {
+                            erase_table.erase(it++);
+                        }
+                    }
+                    else {
+                        ++it;
+                    }
+                }
+                end_t = std::chrono::high_resolution_clock::now();
+                erase_iterate_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count();
+                erase_iterate_cnt += visit_cnt;
+            }
+            if (already_time_out_flag) {
+                result_vec.push_back(IterateVariantsStats{double(element_num)});
+                continue;
+            }
+            stats[3] = double(erase_iterate_ns) / double(erase_iterate_cnt);
+
+            for (size_t i = 0; i < element_num - element_num / 10UL; ++i) {
+                table.erase(src_vec[i].first);
+            }
+            const size_t left_element_num = table.size();
+            start_t = std::chrono::high_resolution_clock::now();
+            for (size_t t = 0; t < iterate_time; ++t) {
+                for (auto it = table.begin(); it != table.end(); ++it) {
+                    useless_sum += *reinterpret_cast<const uint8_t*>(std::addressof(it->second));
+                }
+            }
+            end_t = std::chrono::high_resolution_clock::now();
+            stats[4] = double(std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count())
+                    / double(iterate_time * std::max(left_element_num, size_t(1)));
+        } catch(std::exception &e) {
+            fprintf(stderr, "Catch exception when test iterate variants, element_num: %lu\n%s\n",
+                    element_num, e.what());
+            stats = IterateVariantsStats{double(element_num)};
+        }
+        fprintf(stderr, "%s with %s, %lu elements, iterate one byte %.3f ns, full pair %.3f ns, "
+                        "with 10%% erase %.3f ns, after 90%% erase %.3f ns, and probe %.3f ns per element\n",
+                MAP_NAME, HASH_NAME, element_num, stats[1], stats[2], stats[3], stats[4], stats[5]);
+        result_vec.push_back(stats);
+    }
+    PreventElision(useless_sum);
+    return result_vec;
+}
+
+void BenchIterateVariants(size_t seed, const char* data_dir) {
+    std::string map_name = std::string(MAP_NAME);
+    std::string hash_name = std::string(HASH_NAME);
+    std::string data_dir_path = std::string(data_dir) + PathSeparator();
+    std::vector<size_t> element_num_vec = {1'000UL, 10'000UL, 100'000UL, 1'000'000UL, 10'000'000UL};
+
+    fprintf(stderr, "\n------ Begin to test iterate variants of hash %s with map %s ---\n",
+            HASH_NAME, MAP_NAME);
+
+#ifndef BENCH_ONLY_STRING
+    if (!IsStringOnlyHash(hash_name)) {
+        using UniformUint64RNG = MaskedUint64RNG<UNIFORM>;
+        using MaskSplitBitsUint64RNG = MaskedUint64RNG<MASK_SPLIT_BITS>;
+        {
+            fprintf(stderr, "\nTest iterate variants with mid split bits masked uint64 key\n\n");
+            FILE *export_fp = OpenExportFile(data_dir_path, "iterate_variants",
+                    map_name + "__" + hash_name + "__mask_split_bits_uint64_t__uint64_t.csv");
+            if (export_fp == nullptr) {
+                return;
+            }
+            ExportRowsToCsv(export_fp, ITERATE_VARIANTS_CSV_HEADER, TestIterateVariants<uint64_t, uint64_t,
+                    MaskSplitBitsUint64RNG, UniformUint64RNG>(seed, element_num_vec));
+        }
+        {
+            fprintf(stderr, "\nTest iterate variants with mid split bits masked uint64 key "
+                            "and 56 bytes payload\n\n");
+            FILE *export_fp = OpenExportFile(data_dir_path, "iterate_variants",
+                    map_name + "__" + hash_name + "__mask_split_bits_uint64_t__56bytes_payload.csv");
+            if (export_fp == nullptr) {
+                return;
+            }
+            ExportRowsToCsv(export_fp, ITERATE_VARIANTS_CSV_HEADER, TestIterateVariants<uint64_t, FixSizeStruct<56>,
+                    MaskSplitBitsUint64RNG, FixSizeStructRNG<56>>(seed, element_num_vec));
+        }
+    }
+#endif
+
+#ifndef BENCH_ONLY_INT
+    {
+        using UniformUint64RNG = MaskedUint64RNG<UNIFORM>;
+        using MidStringRNG = StringRNG<24, PRINTABLE_CHARS, false>;
+        fprintf(stderr, "\nTest iterate variants with mid random len string with max length 24\n\n");
+        FILE *export_fp = OpenExportFile(data_dir_path, "iterate_variants",
+                map_name + "__" + hash_name + "__mid_string_max_24__uint64_t.csv");
+        if (export_fp == nullptr) {
+            return;
+        }
+        ExportRowsToCsv(export_fp, ITERATE_VARIANTS_CSV_HEADER, TestIterateVariants<std::string, uint64_t,
+                MidStringRNG, UniformUint64RNG>(seed, element_num_vec));
+    }
+#endif
+}
+
+#endif // BENCH_ITERATE_VARIANTS
+
+#ifdef BENCH_LOOKUP_ORDER
+
+constexpr size_t LOOKUP_ORDER_NUM = std::size(LOOKUP_ORDER_NAMES);
+using LookupOrderStats = std::array<double, 1 + LOOKUP_ORDER_NUM * 2>;
+
+std::string LookupOrderCsvHeader() {
+    std::string header = "element_num";
+    for (const char* hit_or_miss: {"hit", "miss"}) {
+        for (const char* order_name: LOOKUP_ORDER_NAMES) {
+            header += std::string(",avg_") + hit_or_miss + "_" + order_name + "_lookup_ns";
+        }
+    }
+    return header;
+}
+
+/**
+ * Test the hit and miss lookup with the keys in each LookupOrder, report the ns per lookup.
+ * The hit keys are inserted in the order they are generated, which is the insertion order.
+ */
+template<class KeyType, class ValueType, class KeyRandomGen, class ValueRandomGen>
+std::vector<LookupOrderStats> TestLookupOrder(size_t seed, const std::vector<size_t>& element_num_vec,
+                                              CpuTimer& cpu_timer) {
+    using RandomGenerator = RandomPairGen<KeyType, ValueType, KeyRandomGen, ValueRandomGen>;
+    using PairType = std::pair<KeyType, ValueType>;
+    using Table = Map<KeyType, ValueType>;
+
+    constexpr size_t LOOKUP_TIME = 10'000'000ULL;
+
+    std::mt19937_64 random_engine(seed);
+    std::vector<LookupOrderStats> result_vec;
+    bool already_time_out_flag = false;
+    for (size_t element_num: element_num_vec) {
+        LookupOrderStats stats{double(element_num)};
+        if (already_time_out_flag) {
+            result_vec.push_back(stats);
+            continue;
+        }
+        KeySet<KeyType> key_set;
+        auto src_vec = GenUniqueValueVec<RandomGenerator, KeyType, ValueType, PairType>(
+                element_num, element_num, random_engine(), key_set);
+        auto miss_vec = GenUniqueValueVec<RandomGenerator, KeyType, ValueType, PairType>(
+                element_num, element_num * 4ULL, random_engine(), key_set);
+        key_set = {};
+        const size_t construct_seed = random_engine();
+        for (size_t k = 0; k < LOOKUP_ORDER_NUM; ++k) {
+            auto lookup_order = static_cast<LookupOrder>(k);
+            {
+                Table table;
+                auto [lookup_ns, construct_ns] = TestTableLookUp<KEY_IN, false>(table, LOOKUP_TIME, src_vec,
+                        src_vec, construct_seed, false, cpu_timer, nullptr, lookup_order);
+                stats[1 + k] = double(lookup_ns) / double(LOOKUP_TIME);
+            }
+            {
+                Table table;
+                auto [lookup_ns, construct_ns] = TestTableLookUp<KEY_NOT_IN, false>(table, LOOKUP_TIME, src_vec,
+                        miss_vec, construct_seed, false, cpu_timer, nullptr, lookup_order);
+                stats[1 + LOOKUP_ORDER_NUM + k] = double(lookup_ns) / double(LOOKUP_TIME);
+            }
+        }
+        if (stats[1 + RANDOM_ORDER] == 0.0) {
+            already_time_out_flag = true;
+        }
+        fprintf(stderr, "%s with %s, %lu elements, hit lookup ns in", MAP_NAME, HASH_NAME, element_num);
+        for (size_t k = 0; k < LOOKUP_ORDER_NUM; ++k) {
+            fprintf(stderr, " %s: %.3f,", LOOKUP_ORDER_NAMES[k], stats[1 + k]);
+        }
+        fprintf(stderr, " miss lookup ns in");
+        for (size_t k = 0; k < LOOKUP_ORDER_NUM; ++k) {
+            fprintf(stderr, " %s: %.3f,", LOOKUP_ORDER_NAMES[k], stats[1 + LOOKUP_ORDER_NUM + k]);
+        }
+        fprintf(stderr, "\n");
+        result_vec.push_back(stats);
+    }
+    return result_vec;
+}
+
+void BenchLookupOrder(size_t seed, const char* data_dir) {
+    std::string map_name = std::string(MAP_NAME);
+    std::string hash_name = std::string(HASH_NAME);
+    std::string data_dir_path = std::string(data_dir) + PathSeparator();
+    std::vector<size_t> element_num_vec = {1'000UL, 10'000UL, 100'000UL, 1'000'000UL, 10'000'000UL};
+    const std::string csv_header = LookupOrderCsvHeader();
+    cpu_t::CpuTimer cpu_timer;
+
+    fprintf(stderr, "\n------ Begin to test lookup order of hash %s with map %s ---\n",
+            HASH_NAME, MAP_NAME);
+
+#ifndef BENCH_ONLY_STRING
+    if (!IsStringOnlyHash(hash_name)) {
+        using UniformUint64RNG = MaskedUint64RNG<UNIFORM>;
+        using MaskSplitBitsUint64RNG = MaskedUint64RNG<MASK_SPLIT_BITS>;
+        {
+            fprintf(stderr, "\nTest lookup order with mid split bits masked uint64 key\n\n");
+            FILE *export_fp = OpenExportFile(data_dir_path, "lookup_order",
+                    map_name + "__" + hash_name + "__mask_split_bits_uint64_t__uint64_t.csv");
+            if (export_fp == nullptr) {
+                return;
+            }
+            ExportRowsToCsv(export_fp, csv_header, TestLookupOrder<uint64_t, uint64_t,
+                    MaskSplitBitsUint64RNG, UniformUint64RNG>(seed, element_num_vec, cpu_timer));
+        }
+        {
+            fprintf(stderr, "\nTest lookup order with mid split bits masked uint64 key "
+                            "and 56 bytes payload\n\n");
+            FILE *export_fp = OpenExportFile(data_dir_path, "lookup_order",
+                    map_name + "__" + hash_name + "__mask_split_bits_uint64_t__56bytes_payload.csv");
+            if (export_fp == nullptr) {
+                return;
+            }
+            ExportRowsToCsv(export_fp, csv_header, TestLookupOrder<uint64_t, FixSizeStruct<56>,
+                    MaskSplitBitsUint64RNG, FixSizeStructRNG<56>>(seed, element_num_vec, cpu_timer));
+        }
+    }
+#endif
+
+#ifndef BENCH_ONLY_INT
+    {
+        using UniformUint64RNG = MaskedUint64RNG<UNIFORM>;
+        using MidStringRNG = StringRNG<24, PRINTABLE_CHARS, false>;
+        fprintf(stderr, "\nTest lookup order with mid random len string with max length 24\n\n");
+        FILE *export_fp = OpenExportFile(data_dir_path, "lookup_order",
+                map_name + "__" + hash_name + "__mid_string_max_24__uint64_t.csv");
+        if (export_fp == nullptr) {
+            return;
+        }
+        ExportRowsToCsv(export_fp, csv_header, TestLookupOrder<std::string, uint64_t,
+                MidStringRNG, UniformUint64RNG>(seed, element_num_vec, cpu_timer));
+    }
+#endif
+}
+
+#endif // BENCH_LOOKUP_ORDER
+
+#ifdef BENCH_LOAD_FACTOR_SWEEP
+
+static constexpr float SWEEP_MAX_LOAD_FACTOR_ARR[] = {0.25f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.875f, 0.9f, 0.95f, 0.97f};
+
+#ifdef USE_COUNT_ALLOC
+static const char* LOAD_FACTOR_SWEEP_CSV_HEADER = "element_num,max_load_factor,load_factor,bytes_per_element,"
+                                                  "avg_insert_ns,avg_hit_lookup_ns,avg_miss_lookup_ns";
+using LoadFactorSweepStats = std::array<double, 7>;
+#else
+static const char* LOAD_FACTOR_SWEEP_CSV_HEADER = "element_num,max_load_factor,load_factor,"
+                                                  "avg_insert_ns,avg_hit_lookup_ns,avg_miss_lookup_ns";
+using LoadFactorSweepStats = std::array<double, 6>;
+#endif
+
+/**
+ * For each value in SWEEP_MAX_LOAD_FACTOR_ARR, set the max_load_factor of an empty table,
+ * then reserve and insert the elements. Report the achieved load factor, the heap bytes per
+ * element (with the count allocator), the insert time and the hit and miss lookup time.
+ * Maps whose max_load_factor can not be set are skipped, and so are the values which the
+ * map does not read back as set.
+ */
+template<class KeyType, class ValueType, class KeyRandomGen, class ValueRandomGen>
+std::vector<LoadFactorSweepStats> TestLoadFactorSweep(size_t seed, const std::vector<size_t>& element_num_vec) {
+    using RandomGenerator = RandomPairGen<KeyType, ValueType, KeyRandomGen, ValueRandomGen>;
+    using PairType = std::pair<KeyType, ValueType>;
+    using Table = Map<KeyType, ValueType>;
+    using GetKey = SimpleGetKey<PairType>;
+
+    std::vector<LoadFactorSweepStats> result_vec;
+    if constexpr (!detail::has_max_load_factor<Table>::value) {
+        fprintf(stderr, "%s does not support max_load_factor, skip load factor sweep test\n", MAP_NAME);
+        return result_vec;
+    }
+    else {
+        constexpr uint64_t timeout_threshold_ns_per_insert = 20'000ULL; // 20 us
+        constexpr size_t LOOKUP_TIME = 10'000'000ULL;
+
+        std::mt19937_64 random_engine(seed);
+        bool already_time_out_flag = false;
+        for (size_t element_num: element_num_vec) {
+            if (already_time_out_flag) {
+                break;
+            }
+            KeySet<KeyType> key_set;
+            auto src_vec = GenUniqueValueVec<RandomGenerator, KeyType, ValueType, PairType>(
+                    element_num, element_num, random_engine(), key_set);
+            auto miss_vec = GenUniqueValueVec<RandomGenerator, KeyType, ValueType, PairType>(
+                    element_num, element_num * 4ULL, random_engine(), key_set);
+            key_set = {};
+            auto hit_vec = src_vec;
+            std::shuffle(hit_vec.begin(), hit_vec.end(), random_engine);
+
+            for (float max_load_factor: SWEEP_MAX_LOAD_FACTOR_ARR) {
+                LoadFactorSweepStats stats{double(element_num), double(max_load_factor)};
+                try {
+#ifdef USE_COUNT_ALLOC
+                    size_t start_bytes = count::MemoryCount::instance().cur_bytes();
+#endif
+                    Table table;
+                    table.max_load_factor(max_load_factor);
+                    // Some maps (absl) ignore the max_load_factor and some clamp it, their rows
+                    // would measure the same table under a different label
+                    if (std::fabs(table.max_load_factor() - max_load_factor) > 1e-3f) {
+                        fprintf(stderr, "%s reads back max_load_factor %.3f after setting %.3f, skip it\n",
+                                MAP_NAME, double(table.max_load_factor()), double(max_load_factor));
+                        continue;
+                    }
+                    auto start_t = std::chrono::high_resolution_clock::now();
+                    ConstructTable(table, src_vec, true, false);
+                    auto end_t = std::chrono::high_resolution_clock::now();
+                    uint64_t insert_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count();
+                    if (insert_ns > timeout_threshold_ns_per_insert * element_num) {
+                        fprintf(stderr, "Timeout in construct when test load factor sweep, avg %.3f ns per insert\n",
+                                double(insert_ns) / double(element_num));
+                        already_time_out_flag = true;
+                        break;
+                    }
+                    size_t k = 2;
+                    stats[k++] = table.load_factor();
+#ifdef USE_COUNT_ALLOC
+                    stats[k++] = double(count::MemoryCount::instance().cur_bytes() - start_bytes) / double(element_num);
+#endif
+                    stats[k++] = double(insert_ns) / double(element_num);
+                    stats[k++] = double(TimeTableFind<Table, decltype(hit_vec), GetKey>(
+                            table, LOOKUP_TIME, hit_vec)) / double(LOOKUP_TIME);
+                    stats[k++] = double(TimeTableFind<Table, decltype(miss_vec), GetKey>(
+                            table, LOOKUP_TIME, miss_vec)) / double(LOOKUP_TIME);
+                } catch(std::exception &e) {
+                    fprintf(stderr, "Catch exception when test load factor sweep, element_num: %lu, "
+                                    "max_load_factor: %.3f\n%s\n", element_num, max_load_factor, e.what());
+                    stats = LoadFactorSweepStats{double(element_num), double(max_load_factor)};
+                }
+                fprintf(stderr, "%s with %s, %lu elements, max_load_factor %.3f, load_factor %.3f, "
+                                "insert %.3f ns, find hit %.3f ns, find miss %.3f ns\n",
+                        MAP_NAME, HASH_NAME, element_num, max_load_factor, stats[2],
+                        stats[stats.size() - 3], stats[stats.size() - 2], stats[stats.size() - 1]);
+                result_vec.push_back(stats);
+            }
+        }
+        return result_vec;
+    }
+}
+
+void BenchLoadFactorSweep(size_t seed, const char* data_dir) {
+    std::string map_name = std::string(MAP_NAME);
+    std::string hash_name = std::string(HASH_NAME);
+    std::string data_dir_path = std::string(data_dir) + PathSeparator();
+    std::vector<size_t> element_num_vec = {10'000UL, 100'000UL, 1'000'000UL};
+
+    fprintf(stderr, "\n------ Begin to test load factor sweep of hash %s with map %s ---\n",
+            HASH_NAME, MAP_NAME);
+
+#ifndef BENCH_ONLY_STRING
+    if (!IsStringOnlyHash(hash_name)) {
+        using UniformUint64RNG = MaskedUint64RNG<UNIFORM>;
+        using MaskSplitBitsUint64RNG = MaskedUint64RNG<MASK_SPLIT_BITS>;
+        {
+            fprintf(stderr, "\nTest load factor sweep with mid split bits masked uint64 key\n\n");
+            FILE *export_fp = OpenExportFile(data_dir_path, "load_factor_sweep",
+                    map_name + "__" + hash_name + "__mask_split_bits_uint64_t__uint64_t.csv");
+            if (export_fp == nullptr) {
+                return;
+            }
+            ExportRowsToCsv(export_fp, LOAD_FACTOR_SWEEP_CSV_HEADER, TestLoadFactorSweep<uint64_t, uint64_t,
+                    MaskSplitBitsUint64RNG, UniformUint64RNG>(seed, element_num_vec));
+        }
+        {
+            fprintf(stderr, "\nTest load factor sweep with mid split bits masked uint64 key "
+                            "and 56 bytes payload\n\n");
+            FILE *export_fp = OpenExportFile(data_dir_path, "load_factor_sweep",
+                    map_name + "__" + hash_name + "__mask_split_bits_uint64_t__56bytes_payload.csv");
+            if (export_fp == nullptr) {
+                return;
+            }
+            ExportRowsToCsv(export_fp, LOAD_FACTOR_SWEEP_CSV_HEADER, TestLoadFactorSweep<uint64_t, FixSizeStruct<56>,
+                    MaskSplitBitsUint64RNG, FixSizeStructRNG<56>>(seed, element_num_vec));
+        }
+    }
+#endif
+
+#ifndef BENCH_ONLY_INT
+    {
+        using UniformUint64RNG = MaskedUint64RNG<UNIFORM>;
+        using MidStringRNG = StringRNG<24, PRINTABLE_CHARS, false>;
+        fprintf(stderr, "\nTest load factor sweep with mid random len string with max length 24\n\n");
+        FILE *export_fp = OpenExportFile(data_dir_path, "load_factor_sweep",
+                map_name + "__" + hash_name + "__mid_string_max_24__uint64_t.csv");
+        if (export_fp == nullptr) {
+            return;
+        }
+        ExportRowsToCsv(export_fp, LOAD_FACTOR_SWEEP_CSV_HEADER, TestLoadFactorSweep<std::string, uint64_t,
+                MidStringRNG, UniformUint64RNG>(seed, element_num_vec));
+    }
+#endif
+}
+
+#endif // BENCH_LOAD_FACTOR_SWEEP
+
+#ifdef BENCH_PAYLOAD_SWEEP
+
+#ifdef USE_COUNT_ALLOC
+static const char* PAYLOAD_SWEEP_CSV_HEADER = "element_num,payload_bytes,sizeof_value_type,bytes_per_element,"
+                                              "avg_insert_reserve_ns,avg_insert_no_reserve_ns,avg_grow_rehash_ns,"
+                                              "avg_hit_lookup_ns,avg_miss_lookup_ns,avg_hit_touch_payload_ns,"
+                                              "avg_iterate_ns";
+using PayloadSweepStats = std::array<double, 11>;
+#else
+static const char* PAYLOAD_SWEEP_CSV_HEADER = "element_num,payload_bytes,sizeof_value_type,"
+                                              "avg_insert_reserve_ns,avg_insert_no_reserve_ns,avg_grow_rehash_ns,"
+                                              "avg_hit_lookup_ns,avg_miss_lookup_ns,avg_hit_touch_payload_ns,"
+                                              "avg_iterate_ns";
+using PayloadSweepStats = std::array<double, 10>;
+#endif
+
+// The test of a payload size is skipped if the pairs of an element_num take more bytes
+static constexpr size_t PAYLOAD_SWEEP_MAX_PAIR_BYTES = 512ULL * 1024ULL * 1024ULL;
+
+/**
+ * Test the table with FixSizeStruct<payload_size> as the mapped value, all in ns per element:
+ * 1. insert with reserve
+ * 2. insert without reserve, which includes the cost of the rehash during growth
+ * 3. reserve twice the size on a full table, the cost of moving the elements in one rehash
+ * 4. hit and miss lookup
+ * 5. hit lookup which reads all bytes of the found payload
+ * 6. iterate the table reading one byte of the payload, the same as TestTableIterate
+ */
+template<class KeyType, size_t payload_size, class KeyRandomGen>
+void TestPayloadSize(size_t seed, const std::vector<size_t>& element_num_vec,
+                     std::vector<PayloadSweepStats>& result_vec) {
+    using ValueType = FixSizeStruct<payload_size>;
+    using RandomGenerator = RandomPairGen<KeyType, ValueType, KeyRandomGen, FixSizeStructRNG<payload_size>>;
+    using PairType = std::pair<KeyType, ValueType>;
+    using Table = Map<KeyType, ValueType>;
+    using PairVec = std::vector<typename MutableValue<PairType>::type>;
+
+    constexpr uint64_t timeout_threshold_ns_per_insert = 20'000ULL; // 20 us
+    constexpr size_t LOOKUP_TIME = 5'000'000ULL;
+    constexpr size_t TOTAL_ITERATE_ELEMENT_NUM = 20'000'000ULL;
+
+    auto to_avg_ns = [](std::chrono::high_resolution_clock::time_point start_t,
+                        std::chrono::high_resolution_clock::time_point end_t, size_t cnt) {
+        return double(std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count())
+                / double(std::max(cnt, size_t(1)));
+    };
+
+    std::mt19937_64 random_engine(seed);
+    bool already_time_out_flag = false;
+    uint64_t useless_sum = 0;
+    for (size_t element_num: element_num_vec) {
+        PayloadSweepStats stats{double(element_num), double(payload_size), double(sizeof(PairType))};
+        if (element_num * sizeof(PairType) > PAYLOAD_SWEEP_MAX_PAIR_BYTES) {
+            fprintf(stderr, "Skip %lu elements with %lu bytes payload, the pairs are too large\n",
+                    element_num, payload_size);
+            continue;
+        }
+        if (already_time_out_flag) {
+            result_vec.push_back(stats);
+            continue;
+        }
+        KeySet<KeyType> key_set;
+        PairVec src_vec = GenUniqueValueVec<RandomGenerator, KeyType, ValueType, PairType>(
+                element_num, element_num, random_engine(), key_set);
+        std::vector<KeyType> hit_vec, miss_vec;
+        hit_vec.reserve(element_num);
+        miss_vec.reserve(element_num);
+        for (const auto& pair: src_vec) {
+            hit_vec.push_back(pair.first);
+        }
+        for (auto& pair: GenUniqueValueVec<RandomGenerator, KeyType, ValueType, PairType>(
+                element_num, element_num * 4ULL, random_engine(), key_set)) {
+            miss_vec.push_back(std::move(pair.first));
+        }
+        key_set = {};
+        std::shuffle(hit_vec.begin(), hit_vec.end(), random_engine);
+        const size_t iterate_time = std::max(size_t(1), TOTAL_ITERATE_ELEMENT_NUM / element_num);
+
+        try {
+            size_t k = 3;
+#ifdef USE_COUNT_ALLOC
+            size_t start_bytes = count::MemoryCount::instance().cur_bytes();
+#endif
+            Table table;
+            auto start_t = std::chrono::high_resolution_clock::now();
+            ConstructTable(table, src_vec, true, false);
+            auto end_t = std::chrono::high_resolution_clock::now();
+            double insert_ns = to_avg_ns(start_t, end_t, element_num);
+            if (insert_ns > double(timeout_threshold_ns_per_insert)) {
+                fprintf(stderr, "Timeout in construct when test payload sweep, avg %.3f ns per insert\n",
+                        insert_ns);
+                already_time_out_flag = true;
+                result_vec.push_back(stats);
+                continue;
+            }
+#ifdef USE_COUNT_ALLOC
+            stats[k++] = double(count::MemoryCount::instance().cur_bytes() - start_bytes) / double(element_num);
+#endif
+            stats[k++] = insert_ns;
+
+            {
+                Table grow_table;
+                start_t = std::chrono::high_resolution_clock::now();
+                ConstructTable(grow_table, src_vec, false, false);
+                end_t = std::chrono::high_resolution_clock::now();
+                stats[k++] = to_avg_ns(start_t, end_t, element_num);
+
+                // The table is full, so the reserve moves all the elements at once
+                start_t = std::chrono::high_resolution_clock::now();
+                grow_table.reserve(element_num * 2UL);
+                end_t = std::chrono::high_resolution_clock::now();
+                stats[k++] = to_avg_ns(start_t, end_t, element_num);
+            }
+
+            stats[k++] = double(TimeTableFind<Table, decltype(hit_vec), SimpleGetKey<KeyType>>(
+                    table, LOOKUP_TIME, hit_vec)) / double(LOOKUP_TIME);
+            stats[k++] = double(TimeTableFind<Table, decltype(miss_vec), SimpleGetKey<KeyType>>(
+                    table, LOOKUP_TIME, miss_vec)) / double(LOOKUP_TIME);
+
+            size_t look_up_index = 0;
+            start_t = std::chrono::high_resolution_clock::now();
+            for (size_t t = 0; t < LOOKUP_TIME; ++t) {
+                ++look_up_index;
+                if FPH_UNLIKELY(look_up_index >= element_num) {
+                    look_up_index -= element_num;
+                }
+                auto find_it = table.find(hit_vec[look_up_index]);
+                if FPH_LIKELY(find_it != table.end()) {
+                    useless_sum += ReadAllBytes(find_it->second);
+                }
+            }
+            end_t = std::chrono::high_resolution_clock::now();
+            stats[k++] = to_avg_ns(start_t, end_t, LOOKUP_TIME);
+
+            start_t = std::chrono::high_resolution_clock::now();
+            for (size_t t = 0; t < iterate_time; ++t) {
+                for (auto it = table.begin(); it != table.end(); ++it) {
+                    useless_sum += *reinterpret_cast<const uint8_t*>(std::addressof(it->second));
+                }
+            }
+            end_t = std::chrono::high_resolution_clock::now();
+            stats[k++] = to_avg_ns(start_t, end_t, iterate_time * element_num);
+        } catch(std::exception &e) {
+            fprintf(stderr, "Catch exception when test payload sweep, element_num: %lu, payload: %lu bytes\n%s\n",
+                    element_num, payload_size, e.what());
+            stats = PayloadSweepStats{double(element_num), double(payload_size), double(sizeof(PairType))};
+        }
+        fprintf(stderr, "%s with %s, %lu elements, %lu bytes payload, insert %.3f ns, insert no reserve %.3f ns, "
+                        "grow rehash %.3f ns, find hit %.3f ns, find miss %.3f ns, find hit and touch payload "
+                        "%.3f ns, iterate %.3f ns\n",
+                MAP_NAME, HASH_NAME, element_num, payload_size, stats[stats.size() - 7], stats[stats.size() - 6],
+                stats[stats.size() - 5], stats[stats.size() - 4], stats[stats.size() - 3],
+                stats[stats.size() - 2], stats[stats.size() - 1]);
+        result_vec.push_back(stats);
+    }
+    PreventElision(useless_sum);
+}
+
+template<class KeyType, class KeyRandomGen, size_t ...payload_sizes>
+std::vector<PayloadSweepStats> TestPayloadSweep(size_t seed, const std::vector<size_t>& element_num_vec) {
+    std::vector<PayloadSweepStats> result_vec;
+    (TestPayloadSize<KeyType, payload_sizes, KeyRandomGen>(seed, element_num_vec, result_vec), ...);
+    return result_vec;
+}
+
+void BenchPayloadSweep(size_t seed, const char* data_dir) {
+    std::string map_name = std::string(MAP_NAME);
+    std::string hash_name = std::string(HASH_NAME);
+    std::string data_dir_path = std::string(data_dir) + PathSeparator();
+    std::vector<size_t> element_num_vec = {1'000UL, 10'000UL, 100'000UL, 1'000'000UL};
+
+    fprintf(stderr, "\n------ Begin to test payload sweep of hash %s with map %s ---\n",
+            HASH_NAME, MAP_NAME);
+
+#ifndef BENCH_ONLY_STRING
+    if (!IsStringOnlyHash(hash_name)) {
+        using MaskSplitBitsUint64RNG = MaskedUint64RNG<MASK_SPLIT_BITS>;
+        fprintf(stderr, "\nTest payload sweep with mid split bits masked uint64 key\n\n");
+        FILE *export_fp = OpenExportFile(data_dir_path, "payload_sweep",
+                map_name + "__" + hash_name + "__mask_split_bits_uint64_t__payload_sweep.csv");
+        if (export_fp == nullptr) {
+            return;
+        }
+        ExportRowsToCsv(export_fp, PAYLOAD_SWEEP_CSV_HEADER, TestPayloadSweep<uint64_t, MaskSplitBitsUint64RNG,
+                8, 24, 56, 120, 248, 504, 1016>(seed, element_num_vec));
+    }
+#endif
+
+#ifndef BENCH_ONLY_INT
+    {
+        using MidStringRNG = StringRNG<24, PRINTABLE_CHARS, false>;
+        fprintf(stderr, "\nTest payload sweep with mid random len string with max length 24\n\n");
+        FILE *export_fp = OpenExportFile(data_dir_path, "payload_sweep",
+                map_name + "__" + hash_name + "__mid_string_max_24__payload_sweep.csv");
+        if (export_fp == nullptr) {
+            return;
+        }
+        ExportRowsToCsv(export_fp, PAYLOAD_SWEEP_CSV_HEADER, TestPayloadSweep<std::string, MidStringRNG,
+                8, 24, 56, 120, 248, 504, 1016>(seed, element_num_vec));
+    }
+#endif
+}
+
+#endif // BENCH_PAYLOAD_SWEEP
+
+#ifdef BENCH_LEARNED_HASH
+
+static const char* LEARNED_HASH_CSV_HEADER = "element_num,training_ns,hash_mode,avg_build_ns,avg_hit_lookup_ns,"
+                                             "avg_miss_lookup_ns,low_bits_probe_len,high_bits_probe_len";
+using LearnedHashStats = std::array<double, 8>;
+
+/**
+ * Train the hash on the keys (only for the hashes in src/trained-hashes), then build the
+ * table with reserve and look up the keys in and not in it. The training time and the build
+ * time are measured separately. The linear probe lengths of the hash values are reported as
+ * well, to compare how the learned and the standard hashes spread the structured keys.
+ */
+template<class KeyType, class KeyRandomGen>
+std::vector<LearnedHashStats> TestLearnedHash(size_t seed, const std::vector<size_t>& element_num_vec) {
+    using ValueType = uint64_t;
+    using RandomGenerator = RandomPairGen<KeyType, ValueType, KeyRandomGen, MaskedUint64RNG<UNIFORM>>;
+    using PairType = std::pair<KeyType, ValueType>;
+    using Table = Map<KeyType, ValueType>;
+    using GetKey = SimpleGetKey<PairType>;
+    constexpr uint64_t timeout_threshold_ns_per_insert = 20'000ULL; // 20 us
+    constexpr size_t LOOKUP_TIME = 10'000'000ULL;
+
+    std::vector<LearnedHashStats> result_vec;
+    std::mt19937_64 random_engine(seed);
+    for (size_t element_num: element_num_vec) {
+        KeySet<KeyType> key_set;
+        auto src_vec = GenUniqueValueVec<RandomGenerator, KeyType, ValueType, PairType>(
+                element_num, element_num, random_engine(), key_set);
+        auto miss_vec = GenUniqueValueVec<RandomGenerator, KeyType, ValueType, PairType>(
+                element_num, element_num * 4ULL, random_engine(), key_set);
+        key_set = {};
+        auto hit_vec = src_vec;
+        std::shuffle(hit_vec.begin(), hit_vec.end(), random_engine);
+
+        LearnedHashStats stats{double(element_num)};
+#ifdef BENCH_TRAINED_HASH
+        HashTrainingScope<KeyType> hash_training(src_vec, GetKey{});
+        stats[1] = double(hash_training.training_ns);
+        stats[2] = double(hash_training.hash_mode);
+#endif
+        std::vector<size_t> hash_vec;
+        hash_vec.reserve(src_vec.size());
+        typename Table::hasher hasher{};
+        for (const auto& pair: src_vec) {
+            hash_vec.push_back(hasher(GetKey{}(pair)));
+        }
+        stats[6] = bench::LinearProbeLength(hash_vec, false);
+        stats[7] = bench::LinearProbeLength(hash_vec, true);
+        try {
+            Table table;
+            auto start_t = std::chrono::high_resolution_clock::now();
+            ConstructTable(table, src_vec, true, false);
+            auto end_t = std::chrono::high_resolution_clock::now();
+            uint64_t build_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count();
+            stats[3] = double(build_ns) / double(element_num);
+            if (build_ns > timeout_threshold_ns_per_insert * element_num) {
+                fprintf(stderr, "Timeout in construct when test learned hash, avg %.3f ns per insert\n",
+                        stats[3]);
+                stats[3] = 0;
+            }
+            else {
+                stats[4] = double(TimeTableFind<Table, decltype(hit_vec), GetKey>(
+                        table, LOOKUP_TIME, hit_vec)) / double(LOOKUP_TIME);
+                stats[5] = double(TimeTableFind<Table, decltype(miss_vec), GetKey>(
+                        table, LOOKUP_TIME, miss_vec)) / double(LOOKUP_TIME);
+            }
+        } catch(std::exception &e) {
+            fprintf(stderr, "Catch exception when test learned hash, element_num: %lu\n%s\n",
+                    element_num, e.what());
+        }
+        fprintf(stderr, "%s with %s, %lu elements, training %.3f ms, hash mode %d, build %.3f ns, find hit %.3f ns, "
+                        "find miss %.3f ns, probe len of low bits %.3f, of high bits %.3f\n",
+                MAP_NAME, HASH_NAME, element_num, stats[1] / 1e6, int(stats[2]), stats[3], stats[4], stats[5],
+                stats[6], stats[7]);
+        result_vec.push_back(stats);
+        if (stats[3] == 0) {
+            break;
+        }
+    }
+    return result_vec;
+}
+
+template<class KeyRandomGen>
+void TestLearnedHashDataset(size_t seed, const std::vector<size_t>& element_num_vec,
+                            const std::string& data_dir_path, const std::string& key_name) {
+    fprintf(stderr, "\nTest learned hash with %s key\n\n", key_name.c_str());
+    FILE *export_fp = OpenExportFile(data_dir_path, "learned_hash",
+            std::string(MAP_NAME) + "__" + HASH_NAME + "__" + key_name + "__uint64_t.csv");
+    if (export_fp == nullptr) {
+        return;
+    }
+    ExportRowsToCsv(export_fp, LEARNED_HASH_CSV_HEADER,
+                    TestLearnedHash<uint64_t, KeyRandomGen>(seed, element_num_vec));
+}
+
+void BenchLearnedHash(size_t seed, const char* data_dir) {
+    std::string hash_name = std::string(HASH_NAME);
+    std::string data_dir_path = std::string(data_dir) + PathSeparator();
+    std::vector<size_t> element_num_vec = {10'000UL, 100'000UL, 1'000'000UL, 10'000'000UL};
+
+    fprintf(stderr, "\n------ Begin to test learned hash of hash %s with map %s ---\n",
+            HASH_NAME, MAP_NAME);
+
+#ifndef BENCH_ONLY_STRING
+    if (!IsStringOnlyHash(hash_name)) {
+        TestLearnedHashDataset<MaskedUint64RNG<MASK_LOW_BITS>>(seed, element_num_vec, data_dir_path,
+                                                               "mask_low_bits_uint64_t");
+        TestLearnedHashDataset<MaskedUint64RNG<MASK_HIGH_BITS>>(seed, element_num_vec, data_dir_path,
+                                                                "mask_high_bits_uint64_t");
+        TestLearnedHashDataset<MaskedUint64RNG<MASK_SPLIT_BITS>>(seed, element_num_vec, data_dir_path,
+                                                                 "mask_split_bits_uint64_t");
+        TestLearnedHashDataset<MaskedUint64RNG<SEQUENTIAL>>(seed, element_num_vec, data_dir_path,
+                                                            "sequential_uint64_t");
+        TestLearnedHashDataset<MaskedUint64RNG<SEQUENTIAL_WITH_GAPS>>(seed, element_num_vec, data_dir_path,
+                                                                      "sequential_gaps_uint64_t");
+        TestLearnedHashDataset<MaskedUint64RNG<TIMESTAMPS>>(seed, element_num_vec, data_dir_path,
+                                                            "timestamp_uint64_t");
+        TestLearnedHashDataset<MaskedUint64RNG<POINTER_LIKE>>(seed, element_num_vec, data_dir_path,
+                                                              "pointer_like_uint64_t");
+        TestLearnedHashDataset<MaskedUint64RNG<ENTROPY_BITS, 16>>(seed, element_num_vec, data_dir_path,
+                                                                  "entropy_16_bits_uint64_t");
+        TestLearnedHashDataset<MaskedUint64RNG<ENTROPY_BITS, 32>>(seed, element_num_vec, data_dir_path,
+                                                                  "entropy_32_bits_uint64_t");
+        TestLearnedHashDataset<MaskedUint64RNG<ENTROPY_BITS, 48>>(seed, element_num_vec, data_dir_path,
+                                                                  "entropy_48_bits_uint64_t");
+        TestLearnedHashDataset<MaskedUint64RNG<UNIFORM>>(seed, element_num_vec, data_dir_path,
+                                                         "uniform_uint64_t");
+    }
+#endif
+}
+
+#endif // BENCH_LEARNED_HASH
+
+#ifdef BENCH_BATCH_HASH
+
+static const char* BATCH_HASH_CSV_HEADER = "element_num,simd_batch,scalar_hash_ns,batch_hash_ns,find_ns,"
+                                           "hashed_find_ns,batch_hashed_find_ns,insert_ns,hashed_insert_ns,"
+                                           "batch_hashed_insert_ns";
+using BatchHashStats = std::array<double, 10>;
+
+// The number of keys hashed by one HashBatch call in the batched paths
+static constexpr size_t HASH_BATCH_SIZE = 64;
+
+template<bool batched, class Hasher, class Key>
+inline void HashKeyBlock(const Hasher& hasher, const Key* keys, size_t key_num, size_t* out) {
+    if constexpr (batched) {
+        bench::HashBatch(hasher, keys, key_num, out);
+    }
+    else {
+        for (size_t i = 0; i < key_num; ++i) {
+            out[i] = hasher(keys[i]);
+        }
+    }
+}
+
+/**
+ * Walk the keys of key_vec (in order, wrap around) in blocks of at most HASH_BATCH_SIZE keys
+ * for op_time keys, hash each block one key at a time or by HashBatch, and call
+ * block_op(key_index, hash_arr, block_len) on it.
+ * @return the total ns, or 0 if timeout
+ */
+template<bool batched, class Hasher, class Key, class BlockOp>
+uint64_t TimeHashedBlocks(const Hasher& hasher, const std::vector<Key>& key_vec, size_t op_time,
+                          BlockOp block_op) {
+    constexpr int64_t timeout_threshold_ns = 1'000'000'000LL * 120LL; // 120 sec timeout
+    if (key_vec.empty()) {
+        return 0;
+    }
+    size_t hash_arr[HASH_BATCH_SIZE];
+    size_t key_index = 0;
+    auto start_t = std::chrono::high_resolution_clock::now();
+    for (size_t done_cnt = 0; done_cnt < op_time;) {
+        size_t block_len = std::min({HASH_BATCH_SIZE, key_vec.size() - key_index, op_time - done_cnt});
+        HashKeyBlock<batched>(hasher, key_vec.data() + key_index, block_len, hash_arr);
+        block_op(key_index, hash_arr, block_len);
+        done_cnt += block_len;
+        key_index += block_len;
+        if (key_index == key_vec.size()) {
+            key_index = 0;
+            auto cur_t = std::chrono::high_resolution_clock::now();
+            if FPH_UNLIKELY(std::chrono::duration_cast<std::chrono::nanoseconds>(cur_t - start_t).count()
+                            > timeout_threshold_ns) {
+                fprintf(stderr, "Timeout when time batch hash %s with %s\n", MAP_NAME, HASH_NAME);
+                return 0;
+            }
+        }
+    }
+    auto end_t = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count();
+}
+
+/**
+ * Compare the hash alone, the insert and the hit lookup of the table with the keys hashed in
+ * the table, and of the table of HashedKey with the keys hashed by the caller, one at a time
+ * or in batches by HashBatch. Both HashedKey tables get the hash values of Table::hasher, so
+ * the difference between them is the time the batch hashing saves.
+ */
+template<class KeyType, class KeyRandomGen>
+std::vector<BatchHashStats> TestBatchHash(size_t seed, const std::vector<size_t>& element_num_vec) {
+    using ValueType = uint64_t;
+    using RandomGenerator = RandomPairGen<KeyType, ValueType, KeyRandomGen, MaskedUint64RNG<UNIFORM>>;
+    using PairType = std::pair<KeyType, ValueType>;
+    using Table = Map<KeyType, ValueType>;
+    using HashedKeyType = bench::HashedKey<KeyType>;
+    using HashedTable = Map<HashedKeyType, ValueType>;
+    using GetKey = SimpleGetKey<PairType>;
+    using Hasher = typename Table::hasher;
+    constexpr uint64_t timeout_threshold_ns_per_insert = 20'000ULL; // 20 us
+    constexpr size_t LOOKUP_TIME = 10'000'000ULL;
+
+    std::vector<BatchHashStats> result_vec;
+    std::mt19937_64 random_engine(seed);
+    for (size_t element_num: element_num_vec) {
+        KeySet<KeyType> key_set;
+        auto src_vec = GenUniqueValueVec<RandomGenerator, KeyType, ValueType, PairType>(
+                element_num, element_num, random_engine(), key_set);
+        key_set = {};
+        auto hit_vec = src_vec;
+        std::shuffle(hit_vec.begin(), hit_vec.end(), random_engine);
+        std::vector<KeyType> key_vec, hit_key_vec;
+        key_vec.reserve(element_num);
+        hit_key_vec.reserve(element_num);
+        for (size_t i = 0; i < element_num; ++i) {
+            key_vec.push_back(GetKey{}(src_vec[i]));
+            hit_key_vec.push_back(GetKey{}(hit_vec[i]));
+        }
+#ifdef BENCH_TRAINED_HASH
+        HashTrainingScope<KeyType> hash_training(src_vec, GetKey{});
+#endif
+        const Hasher hasher{};
+        BatchHashStats stats{double(element_num), double(bench::has_hash_batch_v<Hasher, KeyType>)};
+
+        size_t checksum = 0;
+        auto sum_hash_values = [&checksum](size_t, const size_t* hash_arr, size_t block_len) {
+            for (size_t i = 0; i < block_len; ++i) {
+                checksum += hash_arr[i];
+            }
+        };
+        stats[2] = double(TimeHashedBlocks<false>(hasher, hit_key_vec, LOOKUP_TIME, sum_hash_values))
+                   / double(LOOKUP_TIME);
+        stats[3] = double(TimeHashedBlocks<true>(hasher, hit_key_vec, LOOKUP_TIME, sum_hash_values))
+                   / double(LOOKUP_TIME);
+        PreventElision(checksum);
+
+        bool timeout = false;
+        try {
+            Table table;
+            auto start_t = std::chrono::high_resolution_clock::now();
+            ConstructTable(table, src_vec, true, false);
+            auto end_t = std::chrono::high_resolution_clock::now();
+            uint64_t build_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count();
+            timeout = build_ns > timeout_threshold_ns_per_insert * element_num;
+            if (!timeout) {
+                stats[7] = double(build_ns) / double(element_num);
+                stats[4] = double(TimeTableFind<Table, decltype(hit_vec), GetKey>(
+                        table, LOOKUP_TIME, hit_vec)) / double(LOOKUP_TIME);
+            }
+        } catch(std::exception &e) {
+            fprintf(stderr, "Catch exception when test batch hash, element_num: %lu\n%s\n",
+                    element_num, e.what());
+        }
+
+        auto test_hashed_table = [&](auto batched) {
+            constexpr bool is_batched = decltype(batched)::value;
+            HashedTable table;
+            table.reserve(element_num);
+            uint64_t build_ns = TimeHashedBlocks<is_batched>(hasher, key_vec, element_num,
+                    [&](size_t key_index, const size_t* hash_arr, size_t block_len) {
+                for (size_t i = 0; i < block_len; ++i) {
+                    table.emplace(HashedKeyType(hash_arr[i], key_vec[key_index + i]),
+                                  src_vec[key_index + i].second);
+                }
+            });
+            stats[is_batched ? 9 : 8] = double(build_ns) / double(element_num);
+            uint64_t find_ns = TimeHashedBlocks<is_batched>(hasher, hit_key_vec, LOOKUP_TIME,
+                    [&](size_t key_index, const size_t* hash_arr, size_t block_len) {
+                for (size_t i = 0; i < block_len; ++i) {
+                    PreventElision(table.find(HashedKeyType(hash_arr[i], hit_key_vec[key_index + i])));
+                }
+            });
+            stats[is_batched ? 6 : 5] = double(find_ns) / double(LOOKUP_TIME);
+        };
+        if (!timeout) {
+            try {
+                test_hashed_table(std::false_type{});
+                test_hashed_table(std::true_type{});
+            } catch(std::exception &e) {
+                fprintf(stderr, "Catch exception when test batch hash, element_num: %lu\n%s\n",
+                        element_num, e.what());
+            }
+        }
+        else {
+            fprintf(stderr, "Timeout in construct when test batch hash, element_num: %lu\n", element_num);
+        }
+        fprintf(stderr, "%s with %s, %lu elements, simd batch %d, hash %.3f ns, batch hash %.3f ns, "
+                        "find %.3f ns, hashed find %.3f ns, batch hashed find %.3f ns, insert %.3f ns, "
+                        "hashed insert %.3f ns, batch hashed insert %.3f ns\n",
+                MAP_NAME, HASH_NAME, element_num, int(stats[1]), stats[2], stats[3], stats[4], stats[5],
+                stats[6], stats[7], stats[8], stats[9]);
+        result_vec.push_back(stats);
+        if (timeout) {
+            break;
+        }
+    }
+    return result_vec;
+}
+
+template<class KeyType, class KeyRandomGen>
+void TestBatchHashDataset(size_t seed, const std::vector<size_t>& element_num_vec,
+                          const std::string& data_dir_path, const std::string& key_name) {
+    fprintf(stderr, "\nTest batch hash with %s key\n\n", key_name.c_str());
+    FILE *export_fp = OpenExportFile(data_dir_path, "batch_hash",
+            std::string(MAP_NAME) + "__" + HASH_NAME + "__" + key_name + "__uint64_t.csv");
+    if (export_fp == nullptr) {
+        return;
+    }
+    ExportRowsToCsv(export_fp, BATCH_HASH_CSV_HEADER,
+                    TestBatchHash<KeyType, KeyRandomGen>(seed, element_num_vec));
+}
+
+void BenchBatchHash(size_t seed, const char* data_dir) {
+    std::string hash_name = std::string(HASH_NAME);
+    std::string data_dir_path = std::string(data_dir) + PathSeparator();
+    std::vector<size_t> element_num_vec = {1'000UL, 100'000UL, 1'000'000UL};
+
+    fprintf(stderr, "\n------ Begin to test batch hash of hash %s with map %s ---\n",
+            HASH_NAME, MAP_NAME);
+
+#ifndef BENCH_ONLY_STRING
+    if (!IsStringOnlyHash(hash_name)) {
+        TestBatchHashDataset<uint64_t, MaskedUint64RNG<UNIFORM>>(seed, element_num_vec, data_dir_path,
+                                                                 "uniform_uint64_t");
+        TestBatchHashDataset<uint64_t, MaskedUint64RNG<MASK_SPLIT_BITS>>(seed, element_num_vec, data_dir_path,
+                                                                         "mask_split_bits_uint64_t");
+        TestBatchHashDataset<uint64_t, MaskedUint64RNG<SEQUENTIAL>>(seed, element_num_vec, data_dir_path,
+                                                                    "sequential_uint64_t");
+    }
+#endif
+
+#ifndef BENCH_ONLY_INT
+    TestBatchHashDataset<bench::FixedString<12>, FixedStringRNG<12>>(seed, element_num_vec, data_dir_path,
+                                                                     "small_fixed_string_12");
+    TestBatchHashDataset<bench::FixedString<24>, FixedStringRNG<24>>(seed, element_num_vec, data_dir_path,
+                                                                     "mid_fixed_string_24");
+    TestBatchHashDataset<bench::FixedString<64>, FixedStringRNG<64>>(seed, element_num_vec, data_dir_path,
+                                                                     "long_fixed_string_64");
+#endif
+}
+
+#endif // BENCH_BATCH_HASH
+
+#ifdef BENCH_CACHED_HASH
+
+static const char* CACHED_HASH_CSV_HEADER = "element_num,key_len,hash_ns,insert_ns,insert_no_reserve_ns,"
+                                            "grow_rehash_ns,hit_lookup_ns,miss_lookup_ns,hashed_insert_ns,"
+                                            "hashed_insert_no_reserve_ns,hashed_grow_rehash_ns,"
+                                            "hashed_hit_lookup_ns,hashed_miss_lookup_ns";
+using CachedHashStats = std::array<double, 13>;
+
+#ifndef BENCH_ONLY_INT
+
+// The keys of a size are held in the source, hit and miss vectors and one table at a time,
+// all of them within BIG_STRING_MAX_KEY_BYTES
+static constexpr size_t CACHED_HASH_KEY_COPY_NUM = 4;
+
+/**
+ * Time the table with the string keys, all in ns per element:
+ * 1. insert with reserve, and without reserve which includes the rehash during growth
+ * 2. reserve twice the size on the full table built without reserve, the cost of one rehash
+ * 3. hit and miss lookup
+ * to_table_key(key) makes the key of the table from the string in the timed insert loops, and
+ * to_find_key(lookup_key) makes the key to find from an element of hit_vec or miss_vec in the
+ * timed lookup loops, so the hashing at the caller of HashedKey is counted.
+ * @return false if timeout in construct
+ */
+template<class Table, class ToTableKey, class LookupVec, class ToFindKey>
+bool TimeCachedHashTable(const std::vector<std::string>& key_vec, ToTableKey to_table_key,
+                         LookupVec& hit_vec, LookupVec& miss_vec, ToFindKey to_find_key,
+                         double* stats_ptr) {
+    constexpr uint64_t timeout_threshold_ns_per_insert = 20'000ULL; // 20 us
+    constexpr size_t LOOKUP_TIME = 5'000'000ULL;
+    const size_t element_num = key_vec.size();
+
+    auto to_avg_ns = [](std::chrono::high_resolution_clock::time_point start_t,
+                        std::chrono::high_resolution_clock::time_point end_t, size_t cnt) {
+        return double(std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count())
+               / double(std::max(cnt, size_t(1)));
+    };
+    auto insert_keys = [&](Table& table) {
+        for (size_t i = 0; i < element_num; ++i) {
+            table.emplace(to_table_key(key_vec[i]), uint64_t(i));
+        }
+    };
+    auto time_find = [&](const Table& table, LookupVec& lookup_vec) {
+        size_t look_up_index = 0;
+        auto start_t = std::chrono::high_resolution_clock::now();
+        for (size_t t = 0; t < LOOKUP_TIME; ++t) {
+            ++look_up_index;
+            if FPH_UNLIKELY(look_up_index >= lookup_vec.size()) {
+                look_up_index -= lookup_vec.size();
+            }
+            PreventElision(table.find(to_find_key(lookup_vec[look_up_index])));
+        }
+        auto end_t = std::chrono::high_resolution_clock::now();
+        return to_avg_ns(start_t, end_t, LOOKUP_TIME);
+    };
+
+    // Only one table is alive at a time, so the keys are held by at most one table
+    {
+        Table grow_table;
+        auto start_t = std::chrono::high_resolution_clock::now();
+        insert_keys(grow_table);
+        auto end_t = std::chrono::high_resolution_clock::now();
+        stats_ptr[1] = to_avg_ns(start_t, end_t, element_num);
+        if (stats_ptr[1] > double(timeout_threshold_ns_per_insert)) {
+            fprintf(stderr, "Timeout in construct when test cached hash, avg %.3f ns per insert\n", stats_ptr[1]);
+            stats_ptr[1] = 0;
+            return false;
+        }
+
+        // The table is full, so the reserve moves all the elements at once
+        start_t = std::chrono::high_resolution_clock::now();
+        grow_table.reserve(element_num * 2UL);
+        end_t = std::chrono::high_resolution_clock::now();
+        stats_ptr[2] = to_avg_ns(start_t, end_t, element_num);
+    }
+    Table table;
+    table.reserve(element_num);
+    auto start_t = std::chrono::high_resolution_clock::now();
+    insert_keys(table);
+    auto end_t = std::chrono::high_resolution_clock::now();
+    stats_ptr[0] = to_avg_ns(start_t, end_t, element_num);
+    if (stats_ptr[0] > double(timeout_threshold_ns_per_insert)) {
+        fprintf(stderr, "Timeout in construct when test cached hash, avg %.3f ns per insert\n", stats_ptr[0]);
+        stats_ptr[0] = 0;
+        return false;
+    }
+    stats_ptr[3] = time_find(table, hit_vec);
+    stats_ptr[4] = time_find(table, miss_vec);
+    return true;
+}
+
+/**
+ * Compare the table of std::string keys, which hashes the keys in every insert, lookup and
+ * (if the hash is not stored) rehash, with the table of HashedKey<std::string>, whose keys
+ * carry the hash computed once at the caller. The caller side hashing is done in the timed
+ * loops, before each insert and each lookup, so it is included in the results of HashedKey.
+ */
+template<class KeyRandomGen>
+std::vector<CachedHashStats> TestCachedHash(size_t seed, const std::vector<size_t>& element_num_vec,
+                                            size_t key_len) {
+    using ValueType = uint64_t;
+    using RandomGenerator = RandomPairGen<std::string, ValueType, KeyRandomGen, MaskedUint64RNG<UNIFORM>>;
+    using PairType = std::pair<std::string, ValueType>;
+    using Table = Map<std::string, ValueType>;
+    using HashedKeyType = bench::HashedKey<std::string>;
+    using HashedTable = Map<HashedKeyType, ValueType>;
+    constexpr size_t HASH_TIME = 5'000'000ULL;
+
+    std::vector<CachedHashStats> result_vec;
+    std::mt19937_64 random_engine(seed);
+    for (size_t element_num: element_num_vec) {
+        if (element_num * key_len * CACHED_HASH_KEY_COPY_NUM > BIG_STRING_MAX_KEY_BYTES) {
+            fprintf(stderr, "Skip %lu elements with %lu bytes keys, the keys are too large\n", element_num, key_len);
+            continue;
+        }
+        KeySet<std::string> key_set;
+        std::vector<std::string> key_vec, hit_vec, miss_vec;
+        for (auto& pair: GenUniqueValueVec<RandomGenerator, std::string, ValueType, PairType>(
+                element_num, element_num, random_engine(), key_set)) {
+            key_vec.push_back(std::move(pair.first));
+        }
+        for (auto& pair: GenUniqueValueVec<RandomGenerator, std::string, ValueType, PairType>(
+                element_num, element_num * 4ULL, random_engine(), key_set)) {
+            miss_vec.push_back(std::move(pair.first));
+        }
+        key_set = {};
+        hit_vec = key_vec;
+        std::shuffle(hit_vec.begin(), hit_vec.end(), random_engine);
+
+        // The hash of the plain key, which the caller computes for HashedKey
+        const typename Table::hasher hasher{};
+        CachedHashStats stats{double(element_num), double(key_len)};
+        size_t hash_sum = 0;
+        auto start_t = std::chrono::high_resolution_clock::now();
+        for (size_t t = 0; t < HASH_TIME; ++t) {
+            hash_sum += hasher(hit_vec[t % element_num]);
+        }
+        auto end_t = std::chrono::high_resolution_clock::now();
+        PreventElision(hash_sum);
+        stats[2] = double(std::chrono::duration_cast<std::chrono::nanoseconds>(end_t - start_t).count())
+                   / double(HASH_TIME);
+
+        bool timeout = false;
+        try {
+            timeout = !TimeCachedHashTable<Table>(
+                    key_vec, [](const std::string& key) -> const std::string& { return key; },
+                    hit_vec, miss_vec, [](const std::string& key) -> const std::string& { return key; },
+                    stats.data() + 3);
+
+            // The lookup keys are hashed in place in the timed loop, so the strings are not copied
+            // for each lookup, as the lookup of the plain keys does not copy them either. They are
+            // moved from the plain lookup keys, which are not used any more
+            std::vector<HashedKeyType> hashed_hit_vec, hashed_miss_vec;
+            for (auto& key: hit_vec) {
+                hashed_hit_vec.emplace_back(0, std::move(key));
+            }
+            for (auto& key: miss_vec) {
+                hashed_miss_vec.emplace_back(0, std::move(key));
+            }
+            hit_vec = {};
+            miss_vec = {};
+            if (!timeout) {
+                TimeCachedHashTable<HashedTable>(
+                        key_vec, [&hasher](const std::string& key) { return HashedKeyType(hasher(key), key); },
+                        hashed_hit_vec, hashed_miss_vec,
+                        [&hasher](HashedKeyType& key) -> const HashedKeyType& {
+                            key.hash = hasher(key.key);
+                            return key;
+                        }, stats.data() + 8);
+            }
+        } catch(std::exception &e) {
+            fprintf(stderr, "Catch exception when test cached hash, element_num: %lu\n%s\n",
+                    element_num, e.what());
+        }
+        fprintf(stderr, "%s with %s, %lu elements, %lu bytes keys, hash %.3f ns, insert %.3f ns / %.3f ns, "
+                        "insert no reserve %.3f ns / %.3f ns, grow rehash %.3f ns / %.3f ns, find hit %.3f ns / "
+                        "%.3f ns, find miss %.3f ns / %.3f ns (string / hashed key)\n",
+                MAP_NAME, HASH_NAME, element_num, key_len, stats[2], stats[3], stats[8], stats[4], stats[9],
+                stats[5], stats[10], stats[6], stats[11], stats[7], stats[12]);
+        result_vec.push_back(stats);
+        if (timeout) {
+            break;
+        }
+    }
+    return result_vec;
+}
+
+template<size_t max_len, bool fix_length>
+void TestCachedHashDataset(size_t seed, const std::vector<size_t>& element_num_vec,
+                           const std::string& data_dir_path) {
+    using KeyRNG = StringRNG<max_len, fix_length ? SPLIT_MASK_BYTES : PRINTABLE_CHARS, fix_length>;
+    std::string key_name = (fix_length ? "string_fix_" : "string_max_") + std::to_string(max_len);
+    fprintf(stderr, "\nTest cached hash with %s key\n\n", key_name.c_str());
+    FILE *export_fp = OpenExportFile(data_dir_path, "cached_hash",
+            std::string(MAP_NAME) + "__" + HASH_NAME + "__" + key_name + "__uint64_t.csv");
+    if (export_fp == nullptr) {
+        return;
+    }
+    ExportRowsToCsv(export_fp, CACHED_HASH_CSV_HEADER,
+                    TestCachedHash<KeyRNG>(seed, element_num_vec, max_len));
+}
+#endif // BENCH_ONLY_INT
+
+void BenchCachedHash(size_t seed, const char* data_dir) {
+    std::string data_dir_path = std::string(data_dir) + PathSeparator();
+    std::vector<size_t> element_num_vec = {1'000UL, 100'000UL, 1'000'000UL};
+
+    fprintf(stderr, "\n------ Begin to test cached hash of hash %s with map %s ---\n",
+            HASH_NAME, MAP_NAME);
+
+#ifndef BENCH_ONLY_INT
+    TestCachedHashDataset<64, true>(seed, element_num_vec, data_dir_path);
+    TestCachedHashDataset<128, false>(seed, element_num_vec, data_dir_path);
+    TestCachedHashDataset<256, true>(seed, element_num_vec, data_dir_path);
+    TestCachedHashDataset<1024, true>(seed, element_num_vec, data_dir_path);
+#else
+    (void)seed;
+    (void)element_num_vec;
+#endif
+}
+
+#endif // BENCH_CACHED_HASH
+
+#ifdef BENCH_HASH_QUALITY
+
+// The columns before the avalanche bias of each output bit
+static constexpr size_t HASH_QUALITY_SUMMARY_SIZE = 14;
+using HashQualityStats = std::array<double, HASH_QUALITY_SUMMARY_SIZE + 64>;
+
+std::string HashQualityCsvHeader() {
+    std::string csv_header = "element_num,hash_collision_num,bucket_num,low_bits_chi_square,absl_h1_chi_square,"
+                             "absl_h2_chi_square,low_bits_probe_len_0.5,low_bits_probe_len_0.75,"
+                             "low_bits_probe_len_0.9,high_bits_probe_len_0.5,high_bits_probe_len_0.75,"
+                             "high_bits_probe_len_0.9,avalanche_mean_bias,avalanche_max_bias";
+    for (size_t b = 0; b < 64; ++b) {
+        csv_header += ",avalanche_bias_bit_" + std::to_string(b);
+    }
+    return csv_header;
+}
+
+/**
+ * Measure how the hash spreads the keys of the dataset, see utils/hash_quality.h. The buckets
+ * of the chi-squares are the low bits of the hash values as the power of two tables take them,
+ * and the H1 (the bits above the low 7 bits) and the H2 (the low 7 bits, the tag in the control
+ * bytes) of absl's swiss table. The H1 of absl is also xored with a per table seed, which does
+ * not change the distribution of the buckets.
+ */
+template<class KeyType, class KeyRandomGen>
+std::vector<HashQualityStats> TestHashQuality(size_t seed, const std::vector<size_t>& element_num_vec) {
+    using ValueType = uint64_t;
+    using RandomGenerator = RandomPairGen<KeyType, ValueType, KeyRandomGen, MaskedUint64RNG<UNIFORM>>;
+    using PairType = std::pair<KeyType, ValueType>;
+    using GetKey = SimpleGetKey<PairType>;
+    constexpr size_t ABSL_H2_BITS = 7;
+
+    std::vector<HashQualityStats> result_vec;
+    std::mt19937_64 random_engine(seed);
+    for (size_t element_num: element_num_vec) {
+        KeySet<KeyType> key_set;
+        auto src_vec = GenUniqueValueVec<RandomGenerator, KeyType, ValueType, PairType>(
+                element_num, element_num, random_engine(), key_set);
+        key_set = {};
+#ifdef BENCH_TRAINED_HASH
+        HashTrainingScope<KeyType> hash_training(src_vec, GetKey{});
+#endif
+        const typename Map<KeyType, ValueType>::hasher hasher{};
+        std::vector<KeyType> key_vec;
+        std::vector<size_t> hash_vec;
+        key_vec.reserve(element_num);
+        hash_vec.reserve(element_num);
+        for (const auto& pair: src_vec) {
+            key_vec.push_back(GetKey{}(pair));
+            hash_vec.push_back(hasher(GetKey{}(pair)));
+        }
+        src_vec = {};
+
+        HashQualityStats stats{double(element_num)};
+        {
+            std::vector<size_t> sorted_hash_vec = hash_vec;
+            std::sort(sorted_hash_vec.begin(), sorted_hash_vec.end());
+            size_t collision_num = 0;
+            for (size_t i = 1; i < sorted_hash_vec.size(); ++i) {
+                collision_num += sorted_hash_vec[i] == sorted_hash_vec[i - 1U];
+            }
+            stats[1] = double(collision_num);
+        }
+        size_t bucket_num = 2;
+        while (bucket_num < element_num) {
+            bucket_num <<= 1U;
+        }
+        const size_t bucket_mask = bucket_num - 1U;
+        stats[2] = double(bucket_num);
+        stats[3] = bench::BucketChiSquare(hash_vec, bucket_num, [bucket_mask](size_t hash_value) {
+            return hash_value & bucket_mask;
+        });
+        stats[4] = bench::BucketChiSquare(hash_vec, bucket_num, [bucket_mask](size_t hash_value) {
+            return (hash_value >> ABSL_H2_BITS) & bucket_mask;
+        });
+        stats[5] = bench::BucketChiSquare(hash_vec, 1UL << ABSL_H2_BITS, [](size_t hash_value) {
+            return hash_value & ((1UL << ABSL_H2_BITS) - 1U);
+        });
+        const double load_factor_arr[3] = {0.5, 0.75, 0.9};
+        for (size_t i = 0; i < 3; ++i) {
+            stats[6 + i] = bench::LinearProbeLength(hash_vec, false, load_factor_arr[i]);
+            stats[9 + i] = bench::LinearProbeLength(hash_vec, true, load_factor_arr[i]);
+        }
+        auto bias_arr = bench::AvalancheBias(hasher, key_vec, random_engine());
+        for (size_t b = 0; b < bias_arr.size(); ++b) {
+            stats[12] += bias_arr[b] / double(bias_arr.size());
+            stats[13] = std::max(stats[13], bias_arr[b]);
+            stats[HASH_QUALITY_SUMMARY_SIZE + b] = bias_arr[b];
+        }
+        fprintf(stderr, "%s, %lu elements, %lu collisions, chi-square low bits %.3f, absl h1 %.3f, absl h2 %.3f, "
+                        "probe len low bits %.3f / %.3f / %.3f, high bits %.3f / %.3f / %.3f (load factor "
+                        "0.5 / 0.75 / 0.9), avalanche bias mean %.4f, max %.4f\n",
+                HASH_NAME, element_num, size_t(stats[1]), stats[3], stats[4], stats[5], stats[6], stats[7],
+                stats[8], stats[9], stats[10], stats[11], stats[12], stats[13]);
+        result_vec.push_back(stats);
+    }
+    return result_vec;
+}
+
+template<class KeyType, class KeyRandomGen>
+void TestHashQualityDataset(size_t seed, const std::vector<size_t>& element_num_vec,
+                            const std::string& data_dir_path, const std::string& key_name) {
+    fprintf(stderr, "\nTest hash quality with %s key\n\n", key_name.c_str());
+    FILE *export_fp = OpenExportFile(data_dir_path, "hash_quality",
+            std::string(MAP_NAME) + "__" + HASH_NAME + "__" + key_name + "__uint64_t.csv");
+    if (export_fp == nullptr) {
+        return;
+    }
+    ExportRowsToCsv(export_fp, HashQualityCsvHeader(),
+                    TestHashQuality<KeyType, KeyRandomGen>(seed, element_num_vec));
+}
+
+void BenchHashQuality(size_t seed, const char* data_dir) {
+    std::string hash_name = std::string(HASH_NAME);
+    std::string data_dir_path = std::string(data_dir) + PathSeparator();
+    std::vector<size_t> element_num_vec = {1'000UL, 10'000UL, 100'000UL, 1'000'000UL};
+
+    fprintf(stderr, "\n------ Begin to test hash quality of hash %s with map %s ---\n",
+            HASH_NAME, MAP_NAME);
+
+#ifndef BENCH_ONLY_STRING
+    if (!IsStringOnlyHash(hash_name)) {
+        using MaskHighBitsUint64RNG = MaskedUint64RNG<MASK_HIGH_BITS>;
+        using MaskSplitBitsUint64RNG = MaskedUint64RNG<MASK_SPLIT_BITS>;
+        TestHashQualityDataset<uint64_t, MaskedUint64RNG<UNIFORM>>(
+                seed, element_num_vec, data_dir_path, "uniform_uint64_t");
+        TestHashQualityDataset<uint64_t, MaskHighBitsUint64RNG>(
+                seed, element_num_vec, data_dir_path, "mask_high_bits_uint64_t");
+        TestHashQualityDataset<uint64_t, MaskedUint64RNG<MASK_LOW_BITS>>(
+                seed, element_num_vec, data_dir_path, "mask_low_bits_uint64_t");
+        TestHashQualityDataset<uint64_t, MaskSplitBitsUint64RNG>(
+                seed, element_num_vec, data_dir_path, "mask_split_bits_uint64_t");
+        TestHashQualityDataset<uint64_t, MaskedUint64RNG<SEQUENTIAL>>(
+                seed, element_num_vec, data_dir_path, "sequential_uint64_t");
+        TestHashQualityDataset<uint64_t, MaskedUint64RNG<SEQUENTIAL_WITH_GAPS>>(
+                seed, element_num_vec, data_dir_path, "sequential_gaps_uint64_t");
+        TestHashQualityDataset<uint64_t, MaskedUint64RNG<POINTER_LIKE>>(
+                seed, element_num_vec, data_dir_path, "pointer_like_uint64_t");
+        TestHashQualityDataset<uint64_t, MaskedUint64RNG<TIMESTAMPS>>(
+                seed, element_num_vec, data_dir_path, "timestamp_uint64_t");
+        TestHashQualityDataset<uint64_t, MaskedUint64RNG<ENTROPY_BITS, 16>>(
+                seed, element_num_vec, data_dir_path, "entropy_16_bits_uint64_t");
+        TestHashQualityDataset<uint64_t, MaskedUint64RNG<ENTROPY_BITS, 32>>(
+                seed, element_num_vec, data_dir_path, "entropy_32_bits_uint64_t");
+        TestHashQualityDataset<uint64_t, MaskedUint64RNG<ENTROPY_BITS, 48>>(
+                seed, element_num_vec, data_dir_path, "entropy_48_bits_uint64_t");
+        TestHashQualityDataset<std::pair<uint32_t, uint32_t>, CompositeKeyRNG<std::pair<uint32_t, uint32_t>,
+                MaskHighBitsUint64RNG, MaskHighBitsUint64RNG>>(
+                seed, element_num_vec, data_dir_path, "pair_uint32_t_uint32_t");
+        TestHashQualityDataset<std::pair<uint64_t, uint64_t>, CompositeKeyRNG<std::pair<uint64_t, uint64_t>,
+                MaskSplitBitsUint64RNG, MaskSplitBitsUint64RNG>>(
+                seed, element_num_vec, data_dir_path, "pair_uint64_t_uint64_t");
+#ifdef __SIZEOF_INT128__
+        TestHashQualityDataset<__uint128_t, CompositeKeyRNG<__uint128_t,
+                MaskSplitBitsUint64RNG, MaskSplitBitsUint64RNG>>(
+                seed, element_num_vec, data_dir_path, "uint128_t");
+#endif
+        TestHashQualityDataset<bench::Pod16Key, CompositeKeyRNG<bench::Pod16Key,
+                MaskHighBitsUint64RNG, MaskSplitBitsUint64RNG>>(
+                seed, element_num_vec, data_dir_path, "pod_16bytes");
+    }
+#endif
+
+#ifndef BENCH_ONLY_INT
+    TestHashQualityDataset<std::string, StringRNG<64, PRINTABLE_CHARS, false>>(
+            seed, element_num_vec, data_dir_path, "long_string_max_64");
+    TestHashQualityDataset<std::string, StringRNG<64, SPLIT_MASK_BYTES, true>>(
+            seed, element_num_vec, data_dir_path, "long_string_fix_64");
+    TestHashQualityDataset<bench::FixedString<64>, FixedStringRNG<64>>(
+            seed, element_num_vec, data_dir_path, "long_fixed_string_64");
+    TestHashQualityDataset<std::string, StringRNG<12, PRINTABLE_CHARS, false>>(
+            seed, element_num_vec, data_dir_path, "small_string_max_12");
+    TestHashQualityDataset<std::string, StringRNG<12, SPLIT_MASK_BYTES, true>>(
+            seed, element_num_vec, data_dir_path, "small_string_fix_12");
+    TestHashQualityDataset<bench::FixedString<12>, FixedStringRNG<12>>(
+            seed, element_num_vec, data_dir_path, "small_fixed_string_12");
+    TestHashQualityDataset<std::string, StringRNG<24, PRINTABLE_CHARS, false>>(
+            seed, element_num_vec, data_dir_path, "mid_string_max_24");
+    TestHashQualityDataset<std::string, StringRNG<24, SPLIT_MASK_BYTES, true>>(
+            seed, element_num_vec, data_dir_path, "mid_string_fix_24");
+    TestHashQualityDataset<bench::FixedString<24>, FixedStringRNG<24>>(
+            seed, element_num_vec, data_dir_path, "mid_fixed_string_24");
+    TestHashQualityDataset<std::string, StringRNG<128, URL_PATHS, false>>(
+            seed, element_num_vec, data_dir_path, "url_string");
+    TestHashQualityDataset<std::string, StringRNG<36, UUIDS, false>>(
+            seed, element_num_vec, data_dir_path, "uuid_string");
+    TestHashQualityDataset<std::string, StringRNG<40, IP_ADDRESSES, false>>(
+            seed, element_num_vec, data_dir_path, "ip_string");
+    TestHashQualityDataset<std::string, StringRNG<20, DECIMAL_IDS, false>>(
+            seed, element_num_vec, data_dir_path, "decimal_id_string");
+    TestHashQualityDataset<std::string, StringRNG<128, LOG_NORMAL_LENGTH, false>>(
+            seed, element_num_vec, data_dir_path, "log_normal_string_max_128");
+#endif
+}
+
+#endif // BENCH_HASH_QUALITY
 
 int main(int argc, const char** argv) {
     if (argc < 3) {
-        fprintf(stderr, "Invalid parameters!\nUsage: bench_{map_name}__{hash_name} seed(size_t) export_data_dir\n");
+        fprintf(stderr, "Invalid parameters!\nUsage: bench_{map_name}__{hash_name} seed(size_t) export_data_dir "
+                        "[key_file [string|uint64]]\n");
         return -1;
     }
     size_t seed = std::stoul(std::string(argv[1]));
+#if defined(__APPLE__)
+    // Set QoS to highest priority for benchmark on macOS
+    pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0);
+    fprintf(stderr, "Set macOS QoS to USER_INTERACTIVE for benchmark process\n");
+#endif
+#ifndef BENCH_SKIP_DEFAULT_TESTS
     BenchTest(seed, argv[2]);
+#endif
+    if (argc >= 4) {
+        BenchFileKeys(seed, argv[2], argv[3], argc >= 5 ? argv[4] : nullptr);
+    }
+#ifdef BENCH_MEMORY_BUDGET
+    BenchMemoryBudget(seed, argv[2]);
+#endif
+#ifdef BENCH_MOVE_ENTRIES
+    BenchMoveEntries(seed, argv[2]);
+#endif
+#ifdef BENCH_ITERATE_VARIANTS
+    BenchIterateVariants(seed, argv[2]);
+#endif
+#ifdef BENCH_LOOKUP_ORDER
+    BenchLookupOrder(seed, argv[2]);
+#endif
+#ifdef BENCH_LOAD_FACTOR_SWEEP
+    BenchLoadFactorSweep(seed, argv[2]);
+#endif
+#ifdef BENCH_PAYLOAD_SWEEP
+    BenchPayloadSweep(seed, argv[2]);
+#endif
+#ifdef BENCH_LEARNED_HASH
+    BenchLearnedHash(seed, argv[2]);
+#endif
+#ifdef BENCH_BATCH_HASH
+    BenchBatchHash(seed, argv[2]);
+#endif
+#ifdef BENCH_CACHED_HASH
+    BenchCachedHash(seed, argv[2]);
+#endif
+#ifdef BENCH_HASH_QUALITY
+    BenchHashQuality(seed, argv[2]);
+#endif
     return 0;
 }
@@ -0,0 +1,169 @@
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <array>
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+#include "Hash.h"
+#include "utils/cpu_timer.h"
+
+// The hash only benchmark of one hash of src/hashes or src/backup-hashes, without any table.
+// Each key set is hashed in two ways: the throughput, where the keys are independent and the
+// CPU may overlap the hashes, and the latency, where the key of each hash is picked by the
+// previous hash value, so the hashes run one after another as in a chain of dependent lookups.
+// The string keys of each length 1 to MAX_STRING_LEN are timed both in the inline buffer of
+// std::string (small string optimization) and on the heap, to explain the cost curve of the
+// string results of the tables.
+
+using CpuTimer = cpu_t::CpuTimer<uint64_t>;
+
+// The keys of each set, a power of two, which fit in the L2 cache for the longest strings
+static constexpr size_t KEY_NUM = 1024;
+static constexpr size_t HASH_TIME = 1UL << 18U;
+// Take the min of the runs, the others are disturbed by the interrupts and frequency changes
+static constexpr size_t REPEAT_NUM = 7;
+static constexpr size_t MAX_STRING_LEN = 256;
+
+static const char* HASH_BENCH_UINT64_CSV_HEADER = "key_len,throughput_ns,latency_ns";
+static const char* HASH_BENCH_STRING_CSV_HEADER = "key_len,sso_throughput_ns,sso_latency_ns,"
+                                                  "heap_throughput_ns,heap_latency_ns";
+
+// Always 0, but unknown to the compiler, so the key index can depend on the previous hash value
+static volatile size_t opaque_zero = 0;
+
+/**
+ * The min ns per hash of the runs over the keys, the throughput of independent hashes or the
+ * latency of dependent hashes.
+ */
+template<bool dependent, class Key>
+double TimeHash(const std::vector<Key>& key_vec, const CpuTimer& cpu_timer) {
+    static_assert((KEY_NUM & (KEY_NUM - 1U)) == 0);
+    const Hash<Key> hasher{};
+    const size_t zero = opaque_zero;
+    double min_ns = 0;
+    for (size_t r = 0; r < REPEAT_NUM + 1U; ++r) {
+        size_t hash_value = 0;
+        auto start_ticks = CpuTimer::Start();
+        for (size_t i = 0; i < HASH_TIME; ++i) {
+            if constexpr (dependent) {
+                hash_value = hasher(key_vec[(i + (hash_value & zero)) & (KEY_NUM - 1U)]);
+            }
+            else {
+                hash_value = hasher(key_vec[i & (KEY_NUM - 1U)]);
+                cpu_t::DoNotOptimize(hash_value);
+            }
+        }
+        auto end_ticks = CpuTimer::Stop();
+        cpu_t::DoNotOptimize(hash_value);
+        double pass_ns = double(end_ticks - start_ticks) * cpu_timer.ns_per_tick() / double(HASH_TIME);
+        // the first run warms up the caches and the branch predictors
+        if (r == 1 || (r > 1 && pass_ns < min_ns)) {
+            min_ns = pass_ns;
+        }
+    }
+    return min_ns;
+}
+
+std::vector<std::string> GenStringKeys(size_t len, bool on_heap, std::mt19937_64& random_engine) {
+    const size_t sso_capacity = std::string().capacity();
+    std::uniform_int_distribution<int> byte_gen(0, 255);
+    std::vector<std::string> key_vec(KEY_NUM);
+    for (auto& key: key_vec) {
+        if (on_heap) {
+            // A capacity beyond the inline buffer moves the short keys to the heap
+            key.reserve(std::max(len, sso_capacity + 1U));
+        }
+        for (size_t i = 0; i < len; ++i) {
+            key.push_back(char(byte_gen(random_engine)));
+        }
+    }
+    return key_vec;
+}
+
+FILE* OpenHashBenchFile(const std::string& data_dir_path, const std::string& file_name) {
+    std::string export_dir_path = data_dir_path + "hash_bench";
+    std::error_code ec;
+    std::filesystem::create_directories(export_dir_path, ec);
+    if (ec) {
+        fprintf(stderr, "Error when create directory %s\n%s\n", export_dir_path.c_str(),
+                ec.message().c_str());
+        return nullptr;
+    }
+    std::string export_file_path = (std::filesystem::path(export_dir_path) / file_name).string();
+    FILE *export_fp = fopen(export_file_path.c_str(), "w");
+    if (export_fp == nullptr) {
+        fprintf(stderr, "Error when create file at %s\n%s\n", export_file_path.c_str(),
+                std::strerror(errno));
+    }
+    return export_fp;
+}
+
+template<size_t N>
+void ExportRows(FILE* export_fp, const char* csv_header, const std::vector<std::array<double, N>>& row_vec) {
+    fprintf(export_fp, "%s\n", csv_header);
+    for (const auto& row: row_vec) {
+        for (size_t i = 0; i < N; ++i) {
+            fprintf(export_fp, i + 1U == N ? "%lf\n" : "%lf,", row[i]);
+        }
+    }
+    fclose(export_fp);
+}
+
+void BenchUint64Keys(size_t seed, const CpuTimer& cpu_timer, const std::string& data_dir_path) {
+    std::mt19937_64 random_engine(seed);
+    std::vector<uint64_t> key_vec(KEY_NUM);
+    for (auto& key: key_vec) {
+        key = random_engine();
+    }
+    std::array<double, 3> row = {double(sizeof(uint64_t)), TimeHash<false>(key_vec, cpu_timer),
+                                 TimeHash<true>(key_vec, cpu_timer)};
+    fprintf(stderr, "%s uint64_t keys, throughput %.3f ns, latency %.3f ns\n", HASH_NAME, row[1], row[2]);
+    FILE *export_fp = OpenHashBenchFile(data_dir_path, std::string(HASH_NAME) + "__uint64_t.csv");
+    if (export_fp != nullptr) {
+        ExportRows(export_fp, HASH_BENCH_UINT64_CSV_HEADER, std::vector{row});
+    }
+}
+
+void BenchStringKeys(size_t seed, const CpuTimer& cpu_timer, const std::string& data_dir_path) {
+    const size_t sso_capacity = std::string().capacity();
+    std::mt19937_64 random_engine(seed);
+    std::vector<std::array<double, 5>> row_vec;
+    for (size_t len = 1; len <= MAX_STRING_LEN; ++len) {
+        std::array<double, 5> row = {double(len)};
+        // The keys longer than the inline buffer are always on the heap, the sso columns are 0
+        if (len <= sso_capacity) {
+            auto sso_key_vec = GenStringKeys(len, false, random_engine);
+            row[1] = TimeHash<false>(sso_key_vec, cpu_timer);
+            row[2] = TimeHash<true>(sso_key_vec, cpu_timer);
+        }
+        auto heap_key_vec = GenStringKeys(len, true, random_engine);
+        row[3] = TimeHash<false>(heap_key_vec, cpu_timer);
+        row[4] = TimeHash<true>(heap_key_vec, cpu_timer);
+        fprintf(stderr, "%s %zu bytes string keys, sso throughput %.3f ns, latency %.3f ns, "
+                        "heap throughput %.3f ns, latency %.3f ns\n",
+                HASH_NAME, len, row[1], row[2], row[3], row[4]);
+        row_vec.push_back(row);
+    }
+    FILE *export_fp = OpenHashBenchFile(data_dir_path, std::string(HASH_NAME) + "__string.csv");
+    if (export_fp != nullptr) {
+        ExportRows(export_fp, HASH_BENCH_STRING_CSV_HEADER, row_vec);
+    }
+}
+
+int main(int argc, const char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "Invalid parameters!\nUsage: hash_bench__{hash_name} seed(size_t) export_data_dir\n");
+        return -1;
+    }
+    size_t seed = std::stoul(std::string(argv[1]));
+    std::string data_dir_path = (std::filesystem::path(argv[2]) / "").string();
+    CpuTimer cpu_timer;
+
+    fprintf(stderr, "\n------ Begin to test hash %s alone ---\n", HASH_NAME);
+    BenchUint64Keys(seed, cpu_timer, data_dir_path);
+    BenchStringKeys(seed, cpu_timer, data_dir_path);
+    return 0;
+}
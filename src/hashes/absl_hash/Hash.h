@@ -1,8 +1,27 @@
 #pragma once
 
+#include <type_traits>
 #include "absl/hash/hash.h"
+#include "composite_keys.h"
+#include "fixed_string.h"
+#include "hashed_key.h"
 
 static const char* HASH_NAME = "absl::Hash";
 
+namespace absl_hash {
+
+    // absl::Hash supports the pairs, the Pod16Key and the FixedString (by AbslHashValue), the 128-bit
+    // key is hashed as a pair of words
+    template<class Key>
+    struct CompositeHash {
+        size_t operator()(const Key& key) const noexcept {
+            return absl::Hash<std::pair<uint64_t, uint64_t>>{}(bench::ToWords(key));
+        }
+    };
+
+} // namespace absl_hash
+
 template <typename Key>
-using Hash = absl::Hash<Key>;
\ No newline at end of file
+using Hash = std::conditional_t<bench::is_hashed_key_v<Key>, bench::PassthroughHash<Key>,
+        std::conditional_t<bench::is_composite_key_v<Key> && !std::is_class_v<Key>,
+        absl_hash::CompositeHash<Key>, absl::Hash<Key>>>;
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__AES__) && (defined(__x86_64__) || defined(_M_X64))
+#   define AES_HASH_USE_AESNI 1
+#   include <immintrin.h>
+#else
+#   define AES_HASH_USE_AESNI 0
+#   if defined(_MSC_VER) && SIZE_MAX == UINT64_MAX
+#       include <intrin.h>
+#       ifdef _M_X64
+#           pragma intrinsic(_umul128)
+#       endif
+#   endif
+#endif
+
+#include "composite_keys.h"
+#include "fixed_string.h"
+#include "hashed_key.h"
+
+static const char* HASH_NAME = "aes_hash";
+
+// A hash built on the AES round instruction in the style of aHash and gxHash. One AES round
+// mixes each byte with the 3 other bytes of its column, two rounds mix all the 16 bytes, so
+// the integers take two rounds and the strings absorb 16 bytes per round. When AES-NI is not
+// available, the folded multiply of aHash is used instead.
+namespace aes_hash {
+
+    // The digits of pi, as in aHash
+    constexpr uint64_t kSeed0 = UINT64_C(0x243f6a8885a308d3);
+    constexpr uint64_t kSeed1 = UINT64_C(0x13198a2e03707344);
+    constexpr uint64_t kSeed2 = UINT64_C(0xa4093822299f31d0);
+    constexpr uint64_t kSeed3 = UINT64_C(0x082efa98ec4e6c89);
+
+    inline uint64_t Load64(const char* src) {
+        uint64_t x;
+        memcpy(&x, src, sizeof(x));
+        return x;
+    }
+
+    inline uint32_t Load32(const char* src) {
+        uint32_t x;
+        memcpy(&x, src, sizeof(x));
+        return x;
+    }
+
+    // Read the up to 16 bytes as two words without reading out of the range, the two
+    // loads overlap if len < 16
+    inline void LoadSmall(const char* src, size_t len, uint64_t& low, uint64_t& high) {
+        if (len >= 8) {
+            low = Load64(src);
+            high = Load64(src + len - 8);
+        }
+        else if (len >= 4) {
+            low = Load32(src);
+            high = Load32(src + len - 4);
+        }
+        else if (len > 0) {
+            low = (uint64_t(uint8_t(src[0])) << 16U) | (uint64_t(uint8_t(src[len / 2])) << 8U)
+                    | uint8_t(src[len - 1]);
+            high = 0;
+        }
+        else {
+            low = 0;
+            high = 0;
+        }
+    }
+
+#if AES_HASH_USE_AESNI
+
+    inline __m128i Load128(const char* src) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    }
+
+    inline __m128i Keys0() {
+        return _mm_set_epi64x(int64_t(kSeed1), int64_t(kSeed0));
+    }
+
+    inline __m128i Keys1() {
+        return _mm_set_epi64x(int64_t(kSeed3), int64_t(kSeed2));
+    }
+
+    inline uint64_t Finish(__m128i state) {
+        return uint64_t(_mm_cvtsi128_si64(state));
+    }
+
+    inline uint64_t HashWords(uint64_t low, uint64_t high) {
+        __m128i state = _mm_xor_si128(_mm_set_epi64x(int64_t(high), int64_t(low)), Keys0());
+        state = _mm_aesenc_si128(state, Keys1());
+        state = _mm_aesenc_si128(state, Keys0());
+        return Finish(state);
+    }
+
+    inline uint64_t HashInt(uint64_t key) {
+        return HashWords(key, 0);
+    }
+
+    inline uint64_t HashBytes(const char* src, size_t len) {
+        if (len <= 16) {
+            uint64_t low, high;
+            LoadSmall(src, len, low, high);
+            return HashWords(low ^ len, high);
+        }
+        // Two lanes absorb 32 bytes per round, the last 32 bytes are loaded from the end and
+        // may overlap with the bytes already absorbed
+        __m128i lane0 = _mm_xor_si128(Keys0(), _mm_set1_epi64x(int64_t(len)));
+        __m128i lane1 = Keys1();
+        const char* end = src + len;
+        if (len <= 32) {
+            lane0 = _mm_aesenc_si128(lane0, Load128(src));
+            lane1 = _mm_aesenc_si128(lane1, Load128(end - 16));
+        }
+        else {
+            for (; end - src > 32; src += 32) {
+                lane0 = _mm_aesenc_si128(lane0, Load128(src));
+                lane1 = _mm_aesenc_si128(lane1, Load128(src + 16));
+            }
+            lane0 = _mm_aesenc_si128(lane0, Load128(end - 32));
+            lane1 = _mm_aesenc_si128(lane1, Load128(end - 16));
+        }
+        lane0 = _mm_aesenc_si128(lane0, Keys1());
+        lane1 = _mm_aesenc_si128(lane1, Keys0());
+        return Finish(_mm_aesenc_si128(_mm_xor_si128(lane0, lane1), Keys1()));
+    }
+
+#else
+
+    // The xor of the high and low words of the 128-bit product
+    inline uint64_t FoldedMultiply(uint64_t a, uint64_t b) {
+#if defined(_MSC_VER) && defined(_M_X64)
+        uint64_t high;
+        uint64_t low = _umul128(a, b, &high);
+        return low ^ high;
+#elif defined(__SIZEOF_INT128__)
+        __uint128_t product = __uint128_t(a) * b;
+        return uint64_t(product) ^ uint64_t(product >> 64U);
+#else
+        uint64_t a_low = uint32_t(a), a_high = a >> 32U, b_low = uint32_t(b), b_high = b >> 32U;
+        uint64_t low_low = a_low * b_low, low_high = a_low * b_high;
+        uint64_t high_low = a_high * b_low, high_high = a_high * b_high;
+        uint64_t mid = (low_low >> 32U) + uint32_t(low_high) + uint32_t(high_low);
+        uint64_t low = (low_low & 0xffffffffU) | (mid << 32U);
+        uint64_t high = high_high + (low_high >> 32U) + (high_low >> 32U) + (mid >> 32U);
+        return low ^ high;
+#endif
+    }
+
+    inline uint64_t HashWords(uint64_t low, uint64_t high) {
+        return FoldedMultiply(FoldedMultiply(low ^ kSeed0, high ^ kSeed1), kSeed2);
+    }
+
+    inline uint64_t HashInt(uint64_t key) {
+        return FoldedMultiply(FoldedMultiply(key ^ kSeed0, kSeed1), kSeed2);
+    }
+
+    inline uint64_t HashBytes(const char* src, size_t len) {
+        uint64_t low, high;
+        if (len <= 16) {
+            LoadSmall(src, len, low, high);
+            return HashWords(low ^ len, high);
+        }
+        uint64_t state = kSeed3 ^ len;
+        const char* end = src + len;
+        for (; end - src > 16; src += 16) {
+            state = FoldedMultiply(Load64(src) ^ kSeed0, Load64(src + 8) ^ state);
+        }
+        state = FoldedMultiply(Load64(end - 16) ^ kSeed0, Load64(end - 8) ^ state);
+        return FoldedMultiply(state, kSeed2);
+    }
+
+#endif
+
+    template<class Key>
+    struct hash {
+        size_t operator()(const Key& key) const noexcept {
+            return HashInt(static_cast<uint64_t>(key));
+        }
+    };
+
+    template<class CharT>
+    struct hash<std::basic_string<CharT>> {
+        size_t operator()(const std::basic_string<CharT>& src) const noexcept {
+            return HashBytes(reinterpret_cast<const char*>(src.data()), src.length() * sizeof(CharT));
+        }
+    };
+
+    template<class CharT>
+    struct hash<std::basic_string_view<CharT>> {
+        size_t operator()(const std::basic_string_view<CharT>& src) const noexcept {
+            return HashBytes(reinterpret_cast<const char*>(src.data()), src.length() * sizeof(CharT));
+        }
+    };
+
+    // The two 64-bit words of the composite key are hashed as one 16 bytes block
+    template<class Key>
+    struct CompositeHash {
+        size_t operator()(const Key& key) const noexcept {
+            auto [high, low] = bench::ToWords(key);
+            return HashWords(low, high);
+        }
+    };
+
+    template<class Key>
+    struct FixedStringHash {
+        size_t operator()(const Key& key) const noexcept {
+            return HashBytes(key.data, sizeof(key.data));
+        }
+    };
+
+} // namespace aes_hash
+
+template <typename Key>
+using Hash = std::conditional_t<bench::is_hashed_key_v<Key>, bench::PassthroughHash<Key>,
+        std::conditional_t<bench::is_composite_key_v<Key>, aes_hash::CompositeHash<Key>,
+        std::conditional_t<bench::is_fixed_string_v<Key>, aes_hash::FixedStringHash<Key>,
+        aes_hash::hash<Key>>>>;
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__SSE4_2__) && (defined(__x86_64__) || defined(_M_X64))
+#   define CRC32C_HASH_USE_SSE42 1
+#   include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32) && defined(__aarch64__)
+#   define CRC32C_HASH_USE_ARM_CRC 1
+#   include <arm_acle.h>
+#endif
+
+#include "composite_keys.h"
+#include "fixed_string.h"
+#include "hashed_key.h"
+
+static const char* HASH_NAME = "crc32c_hash";
+
+// The CRC32C of the 8 bytes words of the key, computed by the crc32 instruction of SSE4.2
+// (or the CRC extension of arm64). The crc has only 32 bits, which are mostly in the low
+// bits of the 64-bit hash value, so it is multiplied by a 64-bit odd constant at the end to
+// fill the high bits, which are used by the tables like absl::flat_hash_map (H1) and
+// the fibonacci hashing tables.
+namespace crc32c_hash {
+
+    constexpr uint32_t kSeed = 0x9e3779b9U;
+    constexpr uint64_t kFinalMul = UINT64_C(0x9e3779b97f4a7c15);
+
+#if !defined(CRC32C_HASH_USE_SSE42) && !defined(CRC32C_HASH_USE_ARM_CRC)
+    // The byte table of the reflected CRC32C polynomial for the software fallback
+    constexpr std::array<uint32_t, 256> MakeCrcTable() {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int k = 0; k < 8; ++k) {
+                crc = (crc >> 1U) ^ (0x82f63b78U & (0U - (crc & 1U)));
+            }
+            table[i] = crc;
+        }
+        return table;
+    }
+
+    inline constexpr std::array<uint32_t, 256> kCrcTable = MakeCrcTable();
+#endif
+
+    inline uint32_t Crc32Word(uint32_t crc, uint64_t word) {
+#if defined(CRC32C_HASH_USE_SSE42)
+        return uint32_t(_mm_crc32_u64(crc, word));
+#elif defined(CRC32C_HASH_USE_ARM_CRC)
+        return __crc32cd(crc, word);
+#else
+        for (int i = 0; i < 8; ++i) {
+            crc = (crc >> 8U) ^ kCrcTable[(crc ^ word) & 0xffU];
+            word >>= 8U;
+        }
+        return crc;
+#endif
+    }
+
+    inline uint64_t Finalize(uint32_t crc) {
+        return crc * kFinalMul;
+    }
+
+    inline uint64_t Load64(const char* src) {
+        uint64_t x;
+        memcpy(&x, src, sizeof(x));
+        return x;
+    }
+
+    inline uint64_t HashInt(uint64_t key) {
+        return Finalize(Crc32Word(kSeed, key));
+    }
+
+    inline uint64_t HashBytes(const char* src, size_t len) {
+        uint32_t crc = Crc32Word(kSeed, len);
+        if (len < 8) {
+            uint64_t word = 0;
+            memcpy(&word, src, len);
+            return Finalize(Crc32Word(crc, word));
+        }
+        // The last word is loaded from the end, and may overlap with the previous word
+        const char* end = src + len;
+        for (; end - src > 8; src += 8) {
+            crc = Crc32Word(crc, Load64(src));
+        }
+        return Finalize(Crc32Word(crc, Load64(end - 8)));
+    }
+
+    template<class Key>
+    struct hash {
+        size_t operator()(const Key& key) const noexcept {
+            return HashInt(static_cast<uint64_t>(key));
+        }
+    };
+
+    template<class CharT>
+    struct hash<std::basic_string<CharT>> {
+        size_t operator()(const std::basic_string<CharT>& src) const noexcept {
+            return HashBytes(reinterpret_cast<const char*>(src.data()), src.length() * sizeof(CharT));
+        }
+    };
+
+    template<class CharT>
+    struct hash<std::basic_string_view<CharT>> {
+        size_t operator()(const std::basic_string_view<CharT>& src) const noexcept {
+            return HashBytes(reinterpret_cast<const char*>(src.data()), src.length() * sizeof(CharT));
+        }
+    };
+
+    template<class Key>
+    struct CompositeHash {
+        size_t operator()(const Key& key) const noexcept {
+            auto [high, low] = bench::ToWords(key);
+            return Finalize(Crc32Word(Crc32Word(kSeed, high), low));
+        }
+    };
+
+    template<class Key>
+    struct FixedStringHash {
+        size_t operator()(const Key& key) const noexcept {
+            return HashBytes(key.data, sizeof(key.data));
+        }
+    };
+
+} // namespace crc32c_hash
+
+template <typename Key>
+using Hash = std::conditional_t<bench::is_hashed_key_v<Key>, bench::PassthroughHash<Key>,
+        std::conditional_t<bench::is_composite_key_v<Key>, crc32c_hash::CompositeHash<Key>,
+        std::conditional_t<bench::is_fixed_string_v<Key>, crc32c_hash::FixedStringHash<Key>,
+        crc32c_hash::hash<Key>>>>;
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include <functional>
+#include <type_traits>
+#include "composite_keys.h"
+#include "fixed_string.h"
+#include "hashed_key.h"
+#include "hash_batch.h"
+
+static const char* HASH_NAME = "mxm::hash";
+
+namespace uint128_mul {
+
+    inline size_t MulXorMul64(uint64_t x) {
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 56;
+        x *= 0x94d049bb133111ebull;
+        return x;
+    }
+
+    inline uint64_t XorMulXorMulXorMul(uint64_t x) {
+        x ^= x >> 33U;
+        x *= UINT64_C(0xff51afd7ed558ccd);
+        x ^= x >> 33U;
+        x *= UINT64_C(0xc4ceb9fe1a85ec53);
+//        x ^= x >> 33U;
+        return x;
+    }
+
+
+    template<class Key>
+    struct hash {
+        size_t operator()(const Key& key) const noexcept {
+//            return MulXorMul64(key);
+            return XorMulXorMulXorMul(key);
+        }
+
+        // The same mixer as XorMulXorMulXorMul, 4 keys per step with AVX2
+        void HashBatch(const Key* keys, size_t key_num, size_t* out) const {
+            bench::MixBatch<bench::XorMulXorMulMixer>(keys, key_num, out);
+        }
+    };
+
+    template<class CharT>
+    struct hash<std::basic_string<CharT>> {
+        size_t operator()(const std::basic_string<CharT>&src) const noexcept{
+            return std::hash<std::basic_string<CharT>>{}(src);
+        }
+    };
+
+    template<class CharT>
+    struct hash<std::basic_string_view<CharT>> {
+        size_t operator()(const std::basic_string_view<CharT>&src) const noexcept{
+            return std::hash<std::basic_string_view<CharT>>{}(src);
+        }
+    };
+
+    // Mix the low word, combine it with the high word and mix again
+    template<class Key>
+    struct CompositeHash {
+        size_t operator()(const Key& key) const noexcept {
+            auto [high, low] = bench::ToWords(key);
+            return XorMulXorMulXorMul(high ^ XorMulXorMulXorMul(low));
+        }
+    };
+
+    // The strings are hashed by std::hash, and so are the bytes of the fixed strings
+    template<class Key>
+    struct FixedStringHash {
+        size_t operator()(const Key& key) const noexcept {
+            return std::hash<std::string_view>{}(key.view());
+        }
+    };
+} // namespace uint128_mul
+
+template <typename Key>
+using Hash = std::conditional_t<bench::is_hashed_key_v<Key>, bench::PassthroughHash<Key>,
+        std::conditional_t<bench::is_composite_key_v<Key>, uint128_mul::CompositeHash<Key>,
+        std::conditional_t<bench::is_fixed_string_v<Key>, uint128_mul::FixedStringHash<Key>,
+        uint128_mul::hash<Key>>>>;
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "rapidhash.h"
+#include "composite_keys.h"
+#include "fixed_string.h"
+#include "hashed_key.h"
+
+static const char* HASH_NAME = "rapidhash";
+
+namespace rapidhash {
+
+    // The integers are hashed as their 8 bytes, the length is a constant after inlining,
+    // so only the 4 to 16 bytes path is left
+    template<class Key>
+    struct hash {
+        size_t operator()(const Key& key) const noexcept {
+            uint64_t x = static_cast<uint64_t>(key);
+            return Hash(&x, sizeof(x));
+        }
+    };
+
+    template<class CharT>
+    struct hash<std::basic_string<CharT>> {
+        size_t operator()(const std::basic_string<CharT>& src) const noexcept {
+            return Hash(src.data(), src.length() * sizeof(CharT));
+        }
+    };
+
+    template<class CharT>
+    struct hash<std::basic_string_view<CharT>> {
+        size_t operator()(const std::basic_string_view<CharT>& src) const noexcept {
+            return Hash(src.data(), src.length() * sizeof(CharT));
+        }
+    };
+
+    template<class Key>
+    struct CompositeHash {
+        size_t operator()(const Key& key) const noexcept {
+            auto [high, low] = bench::ToWords(key);
+            uint64_t words[2] = {low, high};
+            return Hash(words, sizeof(words));
+        }
+    };
+
+    template<class Key>
+    struct FixedStringHash {
+        size_t operator()(const Key& key) const noexcept {
+            return Hash(key.data, sizeof(key.data));
+        }
+    };
+
+} // namespace rapidhash
+
+template <typename Key>
+using Hash = std::conditional_t<bench::is_hashed_key_v<Key>, bench::PassthroughHash<Key>,
+        std::conditional_t<bench::is_composite_key_v<Key>, rapidhash::CompositeHash<Key>,
+        std::conditional_t<bench::is_fixed_string_v<Key>, rapidhash::FixedStringHash<Key>,
+        rapidhash::hash<Key>>>>;
@@ -0,0 +1,156 @@
+/*
+ * rapidhash - Very fast, high quality, platform-independent hashing algorithm.
+ * Copyright (C) 2024 Nicolas De Carli
+ *
+ * Based on 'wyhash', by Wang Yi <godspeed_china@yeah.net>
+ *
+ * BSD 2-Clause License (https://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * You can contact the author at:
+ *   - rapidhash source repository: https://github.com/Nicoshev/rapidhash
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#if defined(_MSC_VER) && SIZE_MAX == UINT64_MAX
+#   include <intrin.h>
+#   ifdef _M_X64
+#       pragma intrinsic(_umul128)
+#   endif
+#endif
+
+// The rapidhash of Nicolas De Carli (https://github.com/Nicoshev/rapidhash), the successor
+// of wyhash. The keys of at most 16 bytes and of 17 to 48 bytes take their own short paths
+// without a loop, the longer keys are absorbed 48 bytes per round in three independent lanes.
+namespace rapidhash {
+
+    constexpr uint64_t kDefaultSeed = UINT64_C(0xbdd89aa982704029);
+    constexpr uint64_t kSecret[3] = {UINT64_C(0x2d358dccaa6c78a5), UINT64_C(0x8bb84b93962eacc9),
+                                     UINT64_C(0x4b33a62ed433d4a3)};
+
+#if defined(__GNUC__) || defined(__clang__)
+#   define RAPIDHASH_LIKELY(x) __builtin_expect(!!(x), 1)
+#   define RAPIDHASH_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#   define RAPIDHASH_LIKELY(x) (x)
+#   define RAPIDHASH_UNLIKELY(x) (x)
+#endif
+
+    // Replace a and b with the low and high words of their 128-bit product
+    inline void Mum(uint64_t& a, uint64_t& b) {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t product = __uint128_t(a) * b;
+        a = uint64_t(product);
+        b = uint64_t(product >> 64U);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        a = _umul128(a, b, &b);
+#else
+        uint64_t a_high = a >> 32U, b_high = b >> 32U, a_low = uint32_t(a), b_low = uint32_t(b);
+        uint64_t high_high = a_high * b_high, high_low = a_high * b_low;
+        uint64_t low_high = a_low * b_high, low_low = a_low * b_low;
+        uint64_t mid = (low_low >> 32U) + uint32_t(high_low) + uint32_t(low_high);
+        a = (low_low & 0xffffffffU) | (mid << 32U);
+        b = high_high + (high_low >> 32U) + (low_high >> 32U) + (mid >> 32U);
+#endif
+    }
+
+    inline uint64_t Mix(uint64_t a, uint64_t b) {
+        Mum(a, b);
+        return a ^ b;
+    }
+
+    inline uint64_t Read64(const uint8_t* p) {
+        uint64_t x;
+        memcpy(&x, p, sizeof(x));
+        return x;
+    }
+
+    inline uint64_t Read32(const uint8_t* p) {
+        uint32_t x;
+        memcpy(&x, p, sizeof(x));
+        return x;
+    }
+
+    // The first, middle and last bytes of the 1 to 3 bytes key
+    inline uint64_t ReadSmall(const uint8_t* p, size_t len) {
+        return (uint64_t(p[0]) << 56U) | (uint64_t(p[len >> 1U]) << 32U) | p[len - 1];
+    }
+
+    inline uint64_t Hash(const void* key, size_t len, uint64_t seed = kDefaultSeed) {
+        const uint8_t* p = static_cast<const uint8_t*>(key);
+        seed ^= Mix(seed ^ kSecret[0], kSecret[1]) ^ len;
+        uint64_t a, b;
+        if (RAPIDHASH_LIKELY(len <= 16)) {
+            if (RAPIDHASH_LIKELY(len >= 4)) {
+                // Four 4 bytes reads, which overlap if len < 16
+                const uint8_t* p_last = p + len - 4;
+                a = (Read32(p) << 32U) | Read32(p_last);
+                const uint64_t delta = (len & 24U) >> (len >> 3U);
+                b = (Read32(p + delta) << 32U) | Read32(p_last - delta);
+            }
+            else if (RAPIDHASH_LIKELY(len > 0)) {
+                a = ReadSmall(p, len);
+                b = 0;
+            }
+            else {
+                a = b = 0;
+            }
+        }
+        else {
+            size_t i = len;
+            if (RAPIDHASH_UNLIKELY(i > 48)) {
+                uint64_t see1 = seed, see2 = seed;
+                for (; i >= 48; p += 48, i -= 48) {
+                    seed = Mix(Read64(p) ^ kSecret[0], Read64(p + 8) ^ seed);
+                    see1 = Mix(Read64(p + 16) ^ kSecret[1], Read64(p + 24) ^ see1);
+                    see2 = Mix(Read64(p + 32) ^ kSecret[2], Read64(p + 40) ^ see2);
+                }
+                seed ^= see1 ^ see2;
+            }
+            if (i > 16) {
+                seed = Mix(Read64(p) ^ kSecret[2], Read64(p + 8) ^ seed ^ kSecret[1]);
+                if (i > 32) {
+                    seed = Mix(Read64(p + 16) ^ kSecret[2], Read64(p + 24) ^ seed);
+                }
+            }
+            // The last 16 bytes, which may overlap with the bytes already absorbed
+            a = Read64(p + i - 16);
+            b = Read64(p + i - 8);
+        }
+        a ^= kSecret[1];
+        b ^= seed;
+        Mum(a, b);
+        return Mix(a ^ kSecret[0] ^ len, b ^ kSecret[1]);
+    }
+
+#undef RAPIDHASH_LIKELY
+#undef RAPIDHASH_UNLIKELY
+
+} // namespace rapidhash
@@ -1,8 +1,36 @@
 #pragma once
 
+#include <type_traits>
 #include "robin-hood-hashing/src/include/robin_hood.h"
+#include "composite_keys.h"
+#include "fixed_string.h"
+#include "hashed_key.h"
 
 static const char* HASH_NAME = "robin_hood::hash";
 
+namespace robin_hood_hash {
+
+    // Mix the high word with robin_hood::hash_int, combine it with the low word and mix again
+    template<class Key>
+    struct CompositeHash {
+        size_t operator()(const Key& key) const noexcept {
+            auto [high, low] = bench::ToWords(key);
+            return robin_hood::hash_int(robin_hood::hash_int(high) ^ low);
+        }
+    };
+
+    // robin_hood::hash_bytes with the length known at compile time
+    template<class Key>
+    struct FixedStringHash {
+        size_t operator()(const Key& key) const noexcept {
+            return robin_hood::hash_bytes(key.data, sizeof(key.data));
+        }
+    };
+
+} // namespace robin_hood_hash
+
 template <typename Key>
-using Hash = robin_hood::hash<Key>;
\ No newline at end of file
+using Hash = std::conditional_t<bench::is_hashed_key_v<Key>, bench::PassthroughHash<Key>,
+        std::conditional_t<bench::is_composite_key_v<Key>, robin_hood_hash::CompositeHash<Key>,
+        std::conditional_t<bench::is_fixed_string_v<Key>, robin_hood_hash::FixedStringHash<Key>,
+        robin_hood::hash<Key>>>>;
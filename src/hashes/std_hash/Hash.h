@@ -1,9 +1,39 @@
 #pragma once
 
 #include <functional>
+#include <string_view>
+#include <type_traits>
+#include "composite_keys.h"
+#include "fixed_string.h"
+#include "hashed_key.h"
 
 
 static const char* HASH_NAME = "std::hash";
 
+namespace std_hash {
+
+    // Combine the std::hash of the two words of the composite key with the boost hash_combine,
+    // which is how the composite keys are usually hashed with std::hash
+    template<class Key>
+    struct CompositeHash {
+        size_t operator()(const Key& key) const noexcept {
+            auto [high, low] = bench::ToWords(key);
+            return bench::HashCombine(std::hash<uint64_t>{}(high), std::hash<uint64_t>{}(low));
+        }
+    };
+
+    // There is no std::hash of the fixed string. Hash its bytes with the std::hash of the
+    // strings, so the fixed strings and the std::string keys only differ in the key type.
+    template<class Key>
+    struct FixedStringHash {
+        size_t operator()(const Key& key) const noexcept {
+            return std::hash<std::string_view>{}(key.view());
+        }
+    };
+
+} // namespace std_hash
+
 template <typename Key>
-using Hash = std::hash<Key>;
\ No newline at end of file
+using Hash = std::conditional_t<bench::is_hashed_key_v<Key>, bench::PassthroughHash<Key>,
+        std::conditional_t<bench::is_composite_key_v<Key>, std_hash::CompositeHash<Key>,
+        std::conditional_t<bench::is_fixed_string_v<Key>, std_hash::FixedStringHash<Key>, std::hash<Key>>>>;
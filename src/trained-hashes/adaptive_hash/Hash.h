@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "composite_keys.h"
+#include "fixed_string.h"
+#include "hashed_key.h"
+#include "hash_batch.h"
+
+static const char* HASH_NAME = "adaptive_hash";
+
+// A hash for the integer keys which picks its mixing strength from the keys. TrainHash samples
+// the keys before the first insert and measures the entropy of each bit, then sets the mode
+// shared by the hashers of the table: the identity when both the low and the high bits of the
+// keys are random, a single multiplication when only the low bits are random (it keeps the low
+// bits and carries them into the high bits), and the finalizer of MurmurHash3 otherwise, which
+// is also the mode before any training. The mode is checked in every call, so the cost of the
+// dispatch is included in the results. HashBatch dispatches once per batch, and mixes 4 keys
+// per step with AVX2.
+namespace adaptive_hash {
+
+    enum HashMode {
+        FULL_MIX = 0,
+        SINGLE_MULTIPLY,
+        IDENTITY,
+    };
+
+    // The max number of keys sampled to measure the entropy
+    constexpr size_t kMaxSampleNum = 4096;
+    // The min entropy of each checked bit to be treated as random, which is the entropy of
+    // a bit set with probability 0.24 or 0.76
+    constexpr double kMinBitEntropy = 0.8;
+
+    inline double BitEntropy(size_t set_cnt, size_t total_cnt) {
+        double p = double(set_cnt) / double(total_cnt);
+        if (p <= 0.0 || p >= 1.0) {
+            return 0.0;
+        }
+        return -p * std::log2(p) - (1.0 - p) * std::log2(1.0 - p);
+    }
+
+    /**
+     * Sample the keys at random positions (the keys may be sorted, so a sample by stride may
+     * see only some residues), and check the entropy of the floor(log2(n)) - 1 bits at the low
+     * end and at the high end of the keys. These are the bits a dense range of n keys fills
+     * evenly, the top bit of the range is skewed unless n is a power of two.
+     */
+    template<class Key>
+    HashMode ChooseMode(const std::vector<Key>& keys) {
+        if (keys.empty()) {
+            return FULL_MIX;
+        }
+        const size_t sample_num = std::min(kMaxSampleNum, keys.size());
+        std::mt19937_64 random_engine(keys.size());
+        std::uniform_int_distribution<size_t> index_gen(0, keys.size() - 1);
+        size_t set_cnt_arr[64] = {};
+        for (size_t i = 0; i < sample_num; ++i) {
+            uint64_t x = static_cast<uint64_t>(keys[index_gen(random_engine)]);
+            for (size_t b = 0; b < 64; ++b) {
+                set_cnt_arr[b] += (x >> b) & 1U;
+            }
+        }
+        constexpr size_t key_bits = std::min<size_t>(64, sizeof(Key) * 8U);
+        size_t check_bits = 1;
+        while (check_bits < key_bits && (4UL << check_bits) <= keys.size()) {
+            ++check_bits;
+        }
+        double low_entropy = 1.0, high_entropy = 1.0;
+        for (size_t b = 0; b < check_bits; ++b) {
+            low_entropy = std::min(low_entropy, BitEntropy(set_cnt_arr[b], sample_num));
+            high_entropy = std::min(high_entropy, BitEntropy(set_cnt_arr[key_bits - 1 - b], sample_num));
+        }
+        if (low_entropy < kMinBitEntropy) {
+            return FULL_MIX;
+        }
+        return high_entropy < kMinBitEntropy ? SINGLE_MULTIPLY : IDENTITY;
+    }
+
+    // The mode of the last TrainHash of each key type
+    template<class Key>
+    HashMode& CurrentMode() {
+        static HashMode mode = FULL_MIX;
+        return mode;
+    }
+
+    template<class Key>
+    struct AdaptiveHash {
+        AdaptiveHash(): mode_(CurrentMode<Key>()) {}
+
+        size_t operator()(const Key& key) const noexcept {
+            uint64_t x = static_cast<uint64_t>(key);
+            switch (mode_) {
+                case IDENTITY:
+                    return x;
+                case SINGLE_MULTIPLY:
+                    return bench::MultiplyMixer::Scalar(x);
+                default:
+                    return bench::Mix64(x);
+            }
+        }
+
+        void HashBatch(const Key* keys, size_t key_num, size_t* out) const {
+            switch (mode_) {
+                case IDENTITY:
+                    bench::MixBatch<bench::IdentityMixer>(keys, key_num, out);
+                    break;
+                case SINGLE_MULTIPLY:
+                    bench::MixBatch<bench::MultiplyMixer>(keys, key_num, out);
+                    break;
+                default:
+                    bench::MixBatch<bench::Mix64Mixer>(keys, key_num, out);
+                    break;
+            }
+        }
+
+    protected:
+        HashMode mode_;
+    };
+
+    // The keys which are not integers are not sampled
+    template<class Key>
+    struct FallbackHash : std::hash<Key> {};
+
+    template<size_t N>
+    struct FallbackHash<bench::FixedString<N>> {
+        size_t operator()(const bench::FixedString<N>& key) const noexcept {
+            return std::hash<std::string_view>{}(key.view());
+        }
+    };
+
+    template<class Key>
+    struct CompositeHash {
+        size_t operator()(const Key& key) const noexcept {
+            auto [high, low] = bench::ToWords(key);
+            return bench::Mix64(high ^ bench::Mix64(low));
+        }
+    };
+
+} // namespace adaptive_hash
+
+template <typename Key>
+using Hash = std::conditional_t<bench::is_hashed_key_v<Key>, bench::PassthroughHash<Key>,
+        std::conditional_t<bench::is_composite_key_v<Key>, adaptive_hash::CompositeHash<Key>,
+        std::conditional_t<std::is_integral_v<Key>, adaptive_hash::AdaptiveHash<Key>, adaptive_hash::FallbackHash<Key>>>>;
+
+/**
+ * The training hook of the trained hashes, called with the keys before the table is built.
+ * @return the chosen adaptive_hash::HashMode, 0 (FULL_MIX) is the mode of the untrained hash
+ */
+template<class Key>
+int TrainHash(const std::vector<Key>& keys) {
+    if constexpr (std::is_integral_v<Key>) {
+        adaptive_hash::CurrentMode<Key>() = adaptive_hash::ChooseMode(keys);
+        return adaptive_hash::CurrentMode<Key>();
+    }
+    else {
+        (void)keys;
+        return 0;
+    }
+}
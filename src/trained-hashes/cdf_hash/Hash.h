@@ -0,0 +1,287 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "composite_keys.h"
+#include "fixed_string.h"
+#include "hashed_key.h"
+
+static const char* HASH_NAME = "cdf_hash";
+
+// A learned hash for the integer keys, which maps the key to its position in the key set
+// by a piecewise linear model of the cdf, as in "Can Learned Models Replace Hash Functions?"
+// (Sabek et al., VLDB 2022). The model is a two layers recursive model index (RMI): a linear
+// root model picks one of the linear leaf models. The model is trained on a sample of the keys
+// by TrainHash before the table is built, and the hashers constructed after the training
+// share it. A model which does not spread the keys better than a random hash is rejected,
+// and the finalizer of MurmurHash3 is used instead, which is also used before any training.
+namespace cdf_hash {
+
+    inline uint32_t Reverse32(uint32_t x) {
+        x = ((x >> 1U) & 0x55555555U) | ((x & 0x55555555U) << 1U);
+        x = ((x >> 2U) & 0x33333333U) | ((x & 0x33333333U) << 2U);
+        x = ((x >> 4U) & 0x0f0f0f0fU) | ((x & 0x0f0f0f0fU) << 4U);
+        x = ((x >> 8U) & 0x00ff00ffU) | ((x & 0x00ff00ffU) << 8U);
+        return (x >> 16U) | (x << 16U);
+    }
+
+    class CdfModel {
+    public:
+        // The max number of keys sampled to train the model
+        static constexpr size_t MAX_SAMPLE_NUM = 1UL << 16U;
+        // The average number of sampled keys of a leaf model, and the max number of leaves
+        static constexpr size_t SAMPLES_PER_LEAF = 16;
+        static constexpr size_t MAX_LEAF_NUM = 4096;
+
+        /**
+         * Train the model on the keys.
+         * @return nullptr if there are too few keys, or the model does not spread the validation
+         * keys better than a random hash.
+         */
+        template<class Key>
+        static std::shared_ptr<const CdfModel> Train(const std::vector<Key>& keys) {
+            if (keys.size() < 2 * SAMPLES_PER_LEAF) {
+                return nullptr;
+            }
+            // Train on the keys of stride, validate on the keys in the middle of the strides
+            const size_t stride = (keys.size() + MAX_SAMPLE_NUM - 1) / MAX_SAMPLE_NUM;
+            std::vector<uint64_t> sample_vec, validate_vec;
+            sample_vec.reserve(keys.size() / stride + 1);
+            validate_vec.reserve(keys.size() / stride + 1);
+            for (size_t i = 0; i < keys.size(); i += stride) {
+                sample_vec.push_back(static_cast<uint64_t>(keys[i]));
+                validate_vec.push_back(static_cast<uint64_t>(keys[std::min(i + stride / 2, keys.size() - 1)]));
+            }
+            std::sort(sample_vec.begin(), sample_vec.end());
+            sample_vec.erase(std::unique(sample_vec.begin(), sample_vec.end()), sample_vec.end());
+            if (sample_vec.size() < 2 * SAMPLES_PER_LEAF) {
+                return nullptr;
+            }
+            std::shared_ptr<CdfModel> model(new CdfModel());
+            model->Fit(sample_vec);
+            if (!model->SpreadsKeys(validate_vec)) {
+                return nullptr;
+            }
+            return model;
+        }
+
+        /**
+         * The high 32 bits of the hash value are the high 32 bits of the cdf position, and the
+         * low 32 bits are the same bits reversed, so the tables taking the bucket from either the
+         * high bits or the low bits of the hash value get the even spread of the cdf. The keys
+         * outside the range of the training keys, like the next keys of a sequence, would all
+         * get the position of the first or the last leaf, so they are hashed by the finalizer of
+         * MurmurHash3 instead.
+         */
+        uint64_t Hash(uint64_t key) const {
+            if (key < min_key_ || key > max_key_) {
+                return bench::Mix64(key);
+            }
+            uint64_t pos = Predict(key);
+            return (pos & UINT64_C(0xffffffff00000000)) | Reverse32(uint32_t(pos >> 32U));
+        }
+
+        // The position of the key in the cdf, scaled to [0, 2^64)
+        uint64_t Predict(uint64_t key) const {
+            const Leaf& leaf = leaves_[LeafIndex(key)];
+            if (key <= leaf.min_key) {
+                return leaf.min_pos;
+            }
+            double offset = leaf.slope * double(key - leaf.min_key);
+            return offset >= leaf.pos_range ? leaf.max_pos : leaf.min_pos + uint64_t(offset);
+        }
+
+        size_t leaf_num() const {
+            return leaves_.size();
+        }
+
+    protected:
+        struct Leaf {
+            uint64_t min_key;
+            uint64_t min_pos;
+            uint64_t max_pos;
+            double pos_range; // max_pos - min_pos
+            double slope;
+        };
+
+        CdfModel() = default;
+
+        size_t LeafIndex(uint64_t key) const {
+            if (key <= min_key_) {
+                return 0;
+            }
+            double index = root_slope_ * double(key - min_key_) + root_intercept_;
+            // Clamp before the cast, the index of the keys far above the training keys may not
+            // fit in size_t (or be inf), and the conversion of such a double is undefined
+            if (!(index > 0.0)) {
+                return 0;
+            }
+            return size_t(std::min(index, double(leaves_.size() - 1)));
+        }
+
+        static uint64_t ToPos(size_t rank, size_t sample_num) {
+            // 2^64 / sample_num * rank, without overflow
+            return uint64_t((double(rank) / double(sample_num)) * 18446744073709549568.0);
+        }
+
+        void Fit(const std::vector<uint64_t>& sample_vec) {
+            const size_t sample_num = sample_vec.size();
+            const size_t leaf_num = std::min(MAX_LEAF_NUM, sample_num / SAMPLES_PER_LEAF);
+            min_key_ = sample_vec.front();
+            max_key_ = sample_vec.back();
+
+            // The root is the least squares line of the leaf index on the key
+            double sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+            for (size_t i = 0; i < sample_num; ++i) {
+                double x = double(sample_vec[i] - min_key_);
+                double y = double(i) * double(leaf_num) / double(sample_num);
+                sum_x += x;
+                sum_y += y;
+                sum_xx += x * x;
+                sum_xy += x * y;
+            }
+            double n = double(sample_num);
+            double denominator = n * sum_xx - sum_x * sum_x;
+            root_slope_ = denominator > 0 ? (n * sum_xy - sum_x * sum_y) / denominator : 0.0;
+            root_slope_ = std::max(root_slope_, 0.0);
+            root_intercept_ = (sum_y - root_slope_ * sum_x) / n;
+            leaves_.resize(leaf_num);
+
+            // The root is monotone, so each leaf gets a range of the sorted samples. The leaf
+            // is the line from the last sample of the previous leaves to the first sample of
+            // the next leaves, so the keys between the samples are covered as well.
+            std::vector<size_t> first_rank_vec(leaf_num + 1, sample_num);
+            for (size_t i = sample_num; i-- > 0;) {
+                first_rank_vec[LeafIndex(sample_vec[i])] = i;
+            }
+            for (size_t j = leaf_num; j-- > 0;) {
+                first_rank_vec[j] = std::min(first_rank_vec[j], first_rank_vec[j + 1]);
+            }
+            for (size_t j = 0; j < leaf_num; ++j) {
+                size_t begin_rank = first_rank_vec[j] > 0 ? first_rank_vec[j] - 1 : 0;
+                size_t end_rank = std::min(first_rank_vec[j + 1], sample_num - 1);
+                Leaf& leaf = leaves_[j];
+                leaf.min_key = sample_vec[begin_rank];
+                leaf.min_pos = ToPos(begin_rank, sample_num);
+                leaf.max_pos = end_rank + 1 == sample_num ? ToPos(sample_num, sample_num)
+                                                          : ToPos(end_rank, sample_num);
+                leaf.pos_range = double(leaf.max_pos - leaf.min_pos);
+                uint64_t key_range = sample_vec[end_rank] - leaf.min_key;
+                leaf.slope = key_range == 0 ? 0.0 : leaf.pos_range / double(key_range);
+            }
+        }
+
+        // The number of key pairs in the same bucket of a power of two table at the load factor
+        // 0.5 should be at most twice the number of a random hash
+        bool SpreadsOnBuckets(const std::vector<uint64_t>& key_vec) const {
+            size_t bucket_bits = 1;
+            while ((1UL << bucket_bits) < 2 * key_vec.size()) {
+                ++bucket_bits;
+            }
+            std::vector<uint32_t> bucket_cnt_vec(1UL << bucket_bits, 0);
+            double same_bucket_pairs = 0;
+            for (uint64_t key: key_vec) {
+                same_bucket_pairs += bucket_cnt_vec[Hash(key) >> (64U - bucket_bits)]++;
+            }
+            double n = double(key_vec.size());
+            double random_same_bucket_pairs = n * (n - 1) / 2.0 / double(1UL << bucket_bits);
+            return same_bucket_pairs <= 2.0 * random_same_bucket_pairs;
+        }
+
+        // Both the validation keys and the miss keys have to be spread. The miss keys continue
+        // the training keys beyond both ends of their range at the average gap of the keys, like
+        // the lookup misses and the new keys of the erase and insert test of the sequential keys.
+        bool SpreadsKeys(const std::vector<uint64_t>& validate_vec) const {
+            const uint64_t half_num = validate_vec.size() / 2 + 1;
+            const uint64_t gap = std::max((max_key_ - min_key_) / half_num, uint64_t(1));
+            std::vector<uint64_t> miss_vec;
+            miss_vec.reserve(2 * half_num);
+            for (uint64_t i = 1; i <= half_num; ++i) {
+                if (max_key_ <= UINT64_MAX - gap * i) {
+                    miss_vec.push_back(max_key_ + gap * i);
+                }
+                if (min_key_ >= gap * i) {
+                    miss_vec.push_back(min_key_ - gap * i);
+                }
+            }
+            return SpreadsOnBuckets(validate_vec) && SpreadsOnBuckets(miss_vec);
+        }
+
+        uint64_t min_key_ = 0;
+        uint64_t max_key_ = 0;
+        double root_slope_ = 0;
+        double root_intercept_ = 0;
+        std::vector<Leaf> leaves_;
+    };
+
+    // The model of the last TrainHash of each key type
+    template<class Key>
+    std::shared_ptr<const CdfModel>& CurrentModel() {
+        static std::shared_ptr<const CdfModel> model;
+        return model;
+    }
+
+    template<class Key>
+    struct LearnedHash {
+        LearnedHash(): model_(CurrentModel<Key>()) {}
+
+        size_t operator()(const Key& key) const noexcept {
+            uint64_t x = static_cast<uint64_t>(key);
+            if (model_ == nullptr) {
+                return bench::Mix64(x);
+            }
+            return model_->Hash(x);
+        }
+
+    protected:
+        std::shared_ptr<const CdfModel> model_;
+    };
+
+    // The keys which are not integers are not learned
+    template<class Key>
+    struct FallbackHash : std::hash<Key> {};
+
+    template<size_t N>
+    struct FallbackHash<bench::FixedString<N>> {
+        size_t operator()(const bench::FixedString<N>& key) const noexcept {
+            return std::hash<std::string_view>{}(key.view());
+        }
+    };
+
+    template<class Key>
+    struct CompositeHash {
+        size_t operator()(const Key& key) const noexcept {
+            auto [high, low] = bench::ToWords(key);
+            return bench::Mix64(high ^ bench::Mix64(low));
+        }
+    };
+
+} // namespace cdf_hash
+
+template <typename Key>
+using Hash = std::conditional_t<bench::is_hashed_key_v<Key>, bench::PassthroughHash<Key>,
+        std::conditional_t<bench::is_composite_key_v<Key>, cdf_hash::CompositeHash<Key>,
+        std::conditional_t<std::is_integral_v<Key>, cdf_hash::LearnedHash<Key>, cdf_hash::FallbackHash<Key>>>>;
+
+/**
+ * The training hook of the trained hashes, called with the keys before the table is built.
+ * @return 1 if the learned model is used, 0 if the keys are hashed by the fallback mixer
+ */
+template<class Key>
+int TrainHash(const std::vector<Key>& keys) {
+    if constexpr (std::is_integral_v<Key>) {
+        cdf_hash::CurrentModel<Key>() = cdf_hash::CdfModel::Train(keys);
+        return cdf_hash::CurrentModel<Key>() != nullptr ? 1 : 0;
+    }
+    else {
+        (void)keys;
+        return 0;
+    }
+}
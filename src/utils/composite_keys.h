@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <tuple>
+#include <type_traits>
+
+// The composite keys used in the benchmark, and the helpers for the Hash.h of each
+// hash to hash them.
+namespace bench {
+
+    // A 16 bytes POD key, like a (tenant, shard, object) id
+    struct Pod16Key {
+        uint32_t tenant_id;
+        uint32_t shard_id;
+        uint64_t object_id;
+
+        friend bool operator==(const Pod16Key& a, const Pod16Key& b) {
+            return a.tenant_id == b.tenant_id && a.shard_id == b.shard_id && a.object_id == b.object_id;
+        }
+
+        friend bool operator<(const Pod16Key& a, const Pod16Key& b) {
+            return std::tie(a.tenant_id, a.shard_id, a.object_id) < std::tie(b.tenant_id, b.shard_id, b.object_id);
+        }
+
+        template<class H>
+        friend H AbslHashValue(H h, const Pod16Key& key) {
+            return H::combine(std::move(h), key.tenant_id, key.shard_id, key.object_id);
+        }
+    };
+
+    static_assert(sizeof(Pod16Key) == 16 && std::is_trivially_copyable_v<Pod16Key>);
+
+    template<class Key>
+    struct is_composite_key : std::false_type {};
+
+    template<>
+    struct is_composite_key<std::pair<uint32_t, uint32_t>> : std::true_type {};
+
+    template<>
+    struct is_composite_key<std::pair<uint64_t, uint64_t>> : std::true_type {};
+
+#ifdef __SIZEOF_INT128__
+    template<>
+    struct is_composite_key<__uint128_t> : std::true_type {};
+#endif
+
+    template<>
+    struct is_composite_key<Pod16Key> : std::true_type {};
+
+    template<class Key>
+    inline constexpr bool is_composite_key_v = is_composite_key<Key>::value;
+
+    // Split the composite key into two 64-bit words
+    inline std::pair<uint64_t, uint64_t> ToWords(const std::pair<uint32_t, uint32_t>& key) {
+        return {key.first, key.second};
+    }
+
+    inline std::pair<uint64_t, uint64_t> ToWords(const std::pair<uint64_t, uint64_t>& key) {
+        return key;
+    }
+
+#ifdef __SIZEOF_INT128__
+    inline std::pair<uint64_t, uint64_t> ToWords(__uint128_t key) {
+        return {uint64_t(key >> 64U), uint64_t(key)};
+    }
+#endif
+
+    inline std::pair<uint64_t, uint64_t> ToWords(const Pod16Key& key) {
+        return {uint64_t(key.tenant_id) | (uint64_t(key.shard_id) << 32U), key.object_id};
+    }
+
+    // Construct the composite key from two 64-bit words
+    template<class Key>
+    Key FromWords(uint64_t high, uint64_t low) {
+        if constexpr (std::is_same_v<Key, std::pair<uint32_t, uint32_t>>) {
+            return {uint32_t(high), uint32_t(low)};
+        }
+        else if constexpr (std::is_same_v<Key, Pod16Key>) {
+            return Pod16Key{uint32_t(high), uint32_t(high >> 32U), low};
+        }
+#ifdef __SIZEOF_INT128__
+        else if constexpr (std::is_same_v<Key, __uint128_t>) {
+            return (__uint128_t(high) << 64U) | low;
+        }
+#endif
+        else {
+            return Key{high, low};
+        }
+    }
+
+    // The finalizer of MurmurHash3
+    inline uint64_t Mix64(uint64_t x) {
+        x ^= x >> 33U;
+        x *= UINT64_C(0xff51afd7ed558ccd);
+        x ^= x >> 33U;
+        x *= UINT64_C(0xc4ceb9fe1a85ec53);
+        x ^= x >> 33U;
+        return x;
+    }
+
+    // The hash_combine of boost, with the 64-bit golden ratio
+    inline size_t HashCombine(size_t seed, size_t hash_value) {
+        return seed ^ (hash_value + UINT64_C(0x9e3779b97f4a7c15) + (seed << 6U) + (seed >> 2U));
+    }
+
+} // namespace bench
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// The string key with a fixed length and inline storage, like ticker symbols and digests.
+namespace bench {
+
+    template<size_t N>
+    struct FixedString {
+        static_assert(N > 0);
+
+        FixedString() noexcept: data{} {}
+
+        // Copy the first N chars of str, pad with 0 if str is shorter
+        explicit FixedString(std::string_view str) noexcept: data{} {
+            memcpy(data, str.data(), std::min(str.size(), N));
+        }
+
+        std::string_view view() const noexcept {
+            return {data, N};
+        }
+
+        friend bool operator==(const FixedString& a, const FixedString& b) {
+            return memcmp(a.data, b.data, N) == 0;
+        }
+
+        friend bool operator<(const FixedString& a, const FixedString& b) {
+            return memcmp(a.data, b.data, N) < 0;
+        }
+
+        template<class H>
+        friend H AbslHashValue(H h, const FixedString& key) {
+            return H::combine_contiguous(std::move(h), key.data, N);
+        }
+
+        char data[N];
+    };
+
+    template<class Key>
+    struct is_fixed_string : std::false_type {};
+
+    template<size_t N>
+    struct is_fixed_string<FixedString<N>> : std::true_type {};
+
+    template<class Key>
+    inline constexpr bool is_fixed_string_v = is_fixed_string<Key>::value;
+
+} // namespace bench
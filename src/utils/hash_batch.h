@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include "composite_keys.h"
+
+#if defined(__AVX2__) && (defined(__x86_64__) || defined(_M_X64))
+#   define BENCH_HASH_BATCH_AVX2 1
+#   include <immintrin.h>
+#endif
+
+// The batch hashing API. A hasher of a Hash.h may define
+//     void HashBatch(const Key* keys, size_t key_num, size_t* out) const;
+// which writes the same values as calling the hasher on each key, usually with several keys
+// in the lanes of the vector registers. bench::HashBatch calls it when it is defined, and falls
+// back to one key at a time otherwise. The helpers below are the AVX2 versions of the mixers
+// used by the Hash.h (4 keys per instruction), with the scalar tail.
+namespace bench {
+
+    template<class Hasher, class Key, class = void>
+    struct has_hash_batch : std::false_type {};
+
+    template<class Hasher, class Key>
+    struct has_hash_batch<Hasher, Key, std::void_t<decltype(std::declval<const Hasher&>().HashBatch(
+            std::declval<const Key*>(), size_t(0), std::declval<size_t*>()))>> : std::true_type {};
+
+    template<class Hasher, class Key>
+    inline constexpr bool has_hash_batch_v = has_hash_batch<Hasher, Key>::value;
+
+    template<class Hasher, class Key>
+    inline void HashBatch(const Hasher& hasher, const Key* keys, size_t key_num, size_t* out) {
+        if constexpr (has_hash_batch_v<Hasher, Key>) {
+            hasher.HashBatch(keys, key_num, out);
+        }
+        else {
+            for (size_t i = 0; i < key_num; ++i) {
+                out[i] = hasher(keys[i]);
+            }
+        }
+    }
+
+    // The first multiply-xorshift rounds of the murmur finalizer, without the last xorshift,
+    // as used by uint128_mul's mxm hash
+    inline uint64_t XorMulXorMul(uint64_t x) {
+        x ^= x >> 33U;
+        x *= UINT64_C(0xff51afd7ed558ccd);
+        x ^= x >> 33U;
+        x *= UINT64_C(0xc4ceb9fe1a85ec53);
+        return x;
+    }
+
+#ifdef BENCH_HASH_BATCH_AVX2
+    namespace simd {
+
+        // The low 64 bits of the products of the 4 lanes. AVX2 only multiplies 32-bit halves,
+        // so the product is low * low + ((low * high + high * low) << 32), which takes 3
+        // multiplies. AVX-512DQ has the 64-bit multiply of the lanes.
+        inline __m256i Mul64(__m256i a, __m256i b) {
+#if defined(__AVX512DQ__) && defined(__AVX512VL__)
+            return _mm256_mullo_epi64(a, b);
+#else
+            __m256i cross = _mm256_mullo_epi32(a, _mm256_shuffle_epi32(b, 0xb1));
+            __m256i cross_sum = _mm256_add_epi32(cross, _mm256_srli_epi64(cross, 32));
+            return _mm256_add_epi64(_mm256_mul_epu32(a, b), _mm256_slli_epi64(cross_sum, 32));
+#endif
+        }
+
+        inline __m256i XorShift33(__m256i x) {
+            return _mm256_xor_si256(x, _mm256_srli_epi64(x, 33));
+        }
+
+        inline __m256i XorMulXorMul(__m256i x) {
+            x = Mul64(XorShift33(x), _mm256_set1_epi64x(int64_t(UINT64_C(0xff51afd7ed558ccd))));
+            return Mul64(XorShift33(x), _mm256_set1_epi64x(int64_t(UINT64_C(0xc4ceb9fe1a85ec53))));
+        }
+
+        // The 4 lanes version of bench::Mix64
+        inline __m256i Mix64(__m256i x) {
+            return XorShift33(XorMulXorMul(x));
+        }
+
+        template<class Key>
+        inline __m256i Load4(const Key* keys) {
+            static_assert(sizeof(Key) == sizeof(uint64_t) && std::is_integral_v<Key>);
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys));
+        }
+
+        inline void Store4(size_t* out, __m256i x) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), x);
+        }
+
+    } // namespace simd
+#endif
+
+    // The mixers of the integer keys for MixBatch, Scalar mixes one key and Vec mixes 4 keys
+    struct Mix64Mixer {
+        static uint64_t Scalar(uint64_t x) { return Mix64(x); }
+#ifdef BENCH_HASH_BATCH_AVX2
+        static __m256i Vec(__m256i x) { return simd::Mix64(x); }
+#endif
+    };
+
+    struct XorMulXorMulMixer {
+        static uint64_t Scalar(uint64_t x) { return XorMulXorMul(x); }
+#ifdef BENCH_HASH_BATCH_AVX2
+        static __m256i Vec(__m256i x) { return simd::XorMulXorMul(x); }
+#endif
+    };
+
+    // Multiply by the 64-bit golden ratio, as fibonacci hashing
+    struct MultiplyMixer {
+        static constexpr uint64_t kMultiplier = UINT64_C(0x9e3779b97f4a7c15);
+        static uint64_t Scalar(uint64_t x) { return x * kMultiplier; }
+#ifdef BENCH_HASH_BATCH_AVX2
+        static __m256i Vec(__m256i x) { return simd::Mul64(x, _mm256_set1_epi64x(int64_t(kMultiplier))); }
+#endif
+    };
+
+    struct IdentityMixer {
+        static uint64_t Scalar(uint64_t x) { return x; }
+#ifdef BENCH_HASH_BATCH_AVX2
+        static __m256i Vec(__m256i x) { return x; }
+#endif
+    };
+
+    // Apply the mixer to the integer keys, 4 keys per step with AVX2 for the 64-bit keys
+    template<class Mixer, class Key>
+    inline void MixBatch(const Key* keys, size_t key_num, size_t* out) {
+        size_t i = 0;
+#ifdef BENCH_HASH_BATCH_AVX2
+        if constexpr (sizeof(Key) == sizeof(uint64_t)) {
+            for (; i + 4 <= key_num; i += 4) {
+                simd::Store4(out + i, Mixer::Vec(simd::Load4(keys + i)));
+            }
+        }
+#endif
+        for (; i < key_num; ++i) {
+            out[i] = Mixer::Scalar(static_cast<uint64_t>(keys[i]));
+        }
+    }
+
+} // namespace bench
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "composite_keys.h"
+#include "fixed_string.h"
+
+// The measures of how a hash spreads the keys of a dataset, which only depend on the hash values,
+// so a slow or timed out table can be traced to the hash on that dataset: the bucket distribution
+// with the bits the tables take the bucket from, the avalanche of the input bits, and the probe
+// length of a linear probing table.
+namespace bench {
+
+    // Stop the linear probing simulation when the keys probe this many slots on average
+    inline constexpr size_t MAX_AVG_PROBE_LEN = 256;
+
+    /**
+     * The average number of slots probed by the successful lookups in a linear probing table
+     * with a power of two capacity, where the bucket is taken from the low or the high bits of
+     * the hash values. The capacity is the largest one which the hash values fill to the load
+     * factor, and the first load_factor * capacity hash values are inserted. When the average
+     * exceeds MAX_AVG_PROBE_LEN, the average of the keys inserted so far is returned.
+     */
+    inline double LinearProbeLength(const std::vector<size_t>& hash_vec, bool use_high_bits,
+                                    double load_factor = 0.5) {
+        size_t capacity_bits = 1;
+        while (capacity_bits + 1U < sizeof(size_t) * 8U
+               && load_factor * double(2UL << capacity_bits) <= double(hash_vec.size())) {
+            ++capacity_bits;
+        }
+        const size_t mask = (1UL << capacity_bits) - 1U;
+        const size_t key_num = std::min(hash_vec.size(), std::max<size_t>(1, size_t(load_factor * double(mask + 1U))));
+        std::vector<bool> occupied_vec(mask + 1U, false);
+        size_t total_probe_len = 0;
+        for (size_t i = 0; i < key_num; ++i) {
+            size_t hash_value = hash_vec[i];
+            size_t pos = use_high_bits ? hash_value >> (sizeof(size_t) * 8U - capacity_bits) : hash_value & mask;
+            size_t probe_len = 1;
+            while (occupied_vec[pos]) {
+                pos = (pos + 1U) & mask;
+                ++probe_len;
+            }
+            occupied_vec[pos] = true;
+            total_probe_len += probe_len;
+            if (total_probe_len > MAX_AVG_PROBE_LEN * key_num) {
+                return double(total_probe_len) / double(i + 1U);
+            }
+        }
+        return key_num == 0 ? 0.0 : double(total_probe_len) / double(key_num);
+    }
+
+    /**
+     * The chi-square of the counts of bucket_of(hash_value) over bucket_num buckets against the
+     * uniform distribution, divided by its degrees of freedom (bucket_num - 1), so it is about 1
+     * for a random hash of any key number, and grows with the skew of the buckets.
+     */
+    template<class BucketOf>
+    double BucketChiSquare(const std::vector<size_t>& hash_vec, size_t bucket_num, BucketOf bucket_of) {
+        if (hash_vec.empty() || bucket_num < 2) {
+            return 0.0;
+        }
+        std::vector<uint32_t> bucket_cnt_vec(bucket_num, 0);
+        for (size_t hash_value: hash_vec) {
+            ++bucket_cnt_vec[bucket_of(hash_value)];
+        }
+        const double expected_cnt = double(hash_vec.size()) / double(bucket_num);
+        double chi_square = 0.0;
+        for (uint32_t cnt: bucket_cnt_vec) {
+            double diff = double(cnt) - expected_cnt;
+            chi_square += diff * diff;
+        }
+        return chi_square / expected_cnt / double(bucket_num - 1U);
+    }
+
+    // The number of input bits of the key, which FlipKeyBit can flip
+    template<class Key>
+    size_t KeyBitNum(const Key& key) {
+        if constexpr (std::is_same_v<Key, std::string>) {
+            return key.size() * 8U;
+        }
+        else {
+            (void)key;
+            return sizeof(Key) * 8U;
+        }
+    }
+
+    // The copy of the key with the bit-th input bit flipped, bit < KeyBitNum(key)
+    template<class Key>
+    Key FlipKeyBit(const Key& key, size_t bit) {
+        if constexpr (std::is_integral_v<Key>) {
+            return Key(key ^ (Key(1) << bit));
+        }
+        else if constexpr (std::is_same_v<Key, std::string>) {
+            Key flipped = key;
+            flipped[bit / 8U] = char((unsigned char)flipped[bit / 8U] ^ (1U << (bit % 8U)));
+            return flipped;
+        }
+        else if constexpr (is_fixed_string_v<Key>) {
+            Key flipped = key;
+            flipped.data[bit / 8U] = char((unsigned char)flipped.data[bit / 8U] ^ (1U << (bit % 8U)));
+            return flipped;
+        }
+        else {
+            static_assert(is_composite_key_v<Key>, "no input bits to flip for the key type");
+            // Each word holds half of the bits of the key
+            constexpr size_t word_bits = sizeof(Key) * 4U;
+            auto [high, low] = ToWords(key);
+            (bit < word_bits ? low : high) ^= uint64_t(1) << (bit % word_bits);
+            return FromWords<Key>(high, low);
+        }
+    }
+
+    /**
+     * The avalanche bias of each output bit, |2p - 1| where p is the probability that the output
+     * bit flips when one input bit of the key flips, 0 for an ideal hash and 1 for the output bits
+     * which never or always flip. At most sample_num keys of key_vec are sampled, and at most
+     * flip_per_key input bits of each sampled key are flipped, all of them for the short keys.
+     */
+    template<class Hasher, class Key>
+    std::array<double, 64> AvalancheBias(const Hasher& hasher, const std::vector<Key>& key_vec, size_t seed,
+                                         size_t sample_num = 4096, size_t flip_per_key = 64) {
+        std::array<size_t, 64> flip_cnt_arr{};
+        size_t trial_num = 0;
+        std::mt19937_64 random_engine(seed);
+        for (size_t i = 0; i < std::min(sample_num, key_vec.size()); ++i) {
+            const Key& key = key_vec[key_vec.size() <= sample_num ? i : random_engine() % key_vec.size()];
+            const size_t key_bit_num = KeyBitNum(key);
+            if (key_bit_num == 0) {
+                continue;
+            }
+            const uint64_t hash_value = hasher(key);
+            const size_t flip_num = std::min(flip_per_key, key_bit_num);
+            for (size_t j = 0; j < flip_num; ++j) {
+                size_t bit = key_bit_num <= flip_per_key ? j : random_engine() % key_bit_num;
+                uint64_t diff = hash_value ^ uint64_t(hasher(FlipKeyBit(key, bit)));
+                for (size_t b = 0; b < 64; ++b) {
+                    flip_cnt_arr[b] += (diff >> b) & 1U;
+                }
+                ++trial_num;
+            }
+        }
+        std::array<double, 64> bias_arr{};
+        for (size_t b = 0; b < 64 && trial_num != 0; ++b) {
+            bias_arr[b] = std::fabs(2.0 * double(flip_cnt_arr[b]) / double(trial_num) - 1.0);
+        }
+        return bias_arr;
+    }
+
+} // namespace bench
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// The key which carries its hash value, computed by the caller with the hash of the plain key
+// (one at a time or by HashBatch). The Hash.h of each hash maps it to PassthroughHash, so the
+// table does not hash the key again, and the cost of hashing is moved out of the table.
+namespace bench {
+
+    template<class Key>
+    struct HashedKey {
+        HashedKey() = default;
+
+        HashedKey(size_t hash_value, const Key& plain_key): hash(hash_value), key(plain_key) {}
+
+        HashedKey(size_t hash_value, Key&& plain_key): hash(hash_value), key(std::move(plain_key)) {}
+
+        // The keys of the same plain key have the same hash value, compare it first as the tables
+        // storing the hash do
+        friend bool operator==(const HashedKey& a, const HashedKey& b) {
+            return a.hash == b.hash && a.key == b.key;
+        }
+
+        friend bool operator<(const HashedKey& a, const HashedKey& b) {
+            return a.key < b.key;
+        }
+
+        size_t hash;
+        Key key;
+    };
+
+    template<class Key>
+    struct is_hashed_key : std::false_type {};
+
+    template<class Key>
+    struct is_hashed_key<HashedKey<Key>> : std::true_type {};
+
+    template<class Key>
+    inline constexpr bool is_hashed_key_v = is_hashed_key<Key>::value;
+
+    template<class Key>
+    struct PassthroughHash {
+        size_t operator()(const Key& key) const noexcept {
+            return key.hash;
+        }
+    };
+
+} // namespace bench
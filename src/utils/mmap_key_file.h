@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// A file of user supplied keys mapped into the memory, the keys are read from the
+// mapped pages directly so a large file is not loaded into the memory at once.
+namespace bench {
+
+    enum class KeyFileFormat {
+        LINES, // newline separated strings, the empty lines are skipped
+        UINT64_LE, // raw little-endian uint64_t array
+    };
+
+    class MmapKeyFile {
+    public:
+        MmapKeyFile(const MmapKeyFile&) = delete;
+        MmapKeyFile& operator=(const MmapKeyFile&) = delete;
+
+        ~MmapKeyFile() {
+#if !defined(_WIN32) && !defined(_WIN64)
+            if (data_ != nullptr) {
+                munmap(const_cast<char*>(data_), byte_size_);
+            }
+#endif
+        }
+
+        /**
+         * Map the file and count the keys. The last held_out_percent percent of the keys are
+         * held out to be used as the keys not in the table.
+         * @return nullptr if the file can not be mapped or has no key
+         */
+        static std::unique_ptr<MmapKeyFile> Open(const std::string& path, KeyFileFormat format,
+                                                 size_t held_out_percent = 20) {
+#if defined(_WIN32) || defined(_WIN64)
+            (void)format;
+            (void)held_out_percent;
+            fprintf(stderr, "Reading keys from %s is not supported on Windows\n", path.c_str());
+            return nullptr;
+#else
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                fprintf(stderr, "Error when open key file %s\n%s\n", path.c_str(), std::strerror(errno));
+                return nullptr;
+            }
+            struct stat file_stat{};
+            if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+                fprintf(stderr, "Error when get the size of key file %s, or the file is empty\n", path.c_str());
+                close(fd);
+                return nullptr;
+            }
+            size_t byte_size = size_t(file_stat.st_size);
+            void* addr = mmap(nullptr, byte_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (addr == MAP_FAILED) {
+                fprintf(stderr, "Error when mmap key file %s\n%s\n", path.c_str(), std::strerror(errno));
+                return nullptr;
+            }
+            madvise(addr, byte_size, MADV_SEQUENTIAL);
+            std::unique_ptr<MmapKeyFile> key_file(new MmapKeyFile(static_cast<const char*>(addr), byte_size,
+                                                                  format));
+            key_file->CountKeys(held_out_percent);
+            if (key_file->key_end_offset() != byte_size) {
+                fprintf(stderr, "Ignore the last %zu bytes of key file %s, which are not a whole uint64_t\n",
+                        byte_size - key_file->key_end_offset(), path.c_str());
+            }
+            if (key_file->hit_key_num_ == 0 || key_file->hit_key_num_ == key_file->key_num_) {
+                fprintf(stderr, "Too few keys in key file %s\n", path.c_str());
+                return nullptr;
+            }
+            return key_file;
+#endif
+        }
+
+        KeyFileFormat format() const {
+            return format_;
+        }
+
+        size_t key_num() const {
+            return key_num_;
+        }
+
+        // The number of keys before the held out part
+        size_t hit_key_num() const {
+            return hit_key_num_;
+        }
+
+        // The byte offset of the first held out key
+        size_t held_out_offset() const {
+            return held_out_offset_;
+        }
+
+        size_t byte_size() const {
+            return byte_size_;
+        }
+
+        // The byte offset after the last key, the trailing bytes of a uint64 file whose size
+        // is not a multiple of 8 are not a key
+        size_t key_end_offset() const {
+            return format_ == KeyFileFormat::UINT64_LE ? key_num_ * sizeof(uint64_t) : byte_size_;
+        }
+
+        /**
+         * Read the key at the byte offset, the key refers to the mapped memory.
+         * @return the byte offset of the next key, or byte_size() if it is the last one
+         */
+        size_t ReadKey(size_t offset, std::string_view& key) const {
+            while (offset < byte_size_ && (data_[offset] == '\n' || data_[offset] == '\r')) {
+                ++offset;
+            }
+            const char* line_end = static_cast<const char*>(memchr(data_ + offset, '\n', byte_size_ - offset));
+            size_t end_offset = line_end == nullptr ? byte_size_ : size_t(line_end - data_);
+            size_t key_len = end_offset - offset;
+            if (key_len > 0 && data_[offset + key_len - 1] == '\r') {
+                --key_len;
+            }
+            key = std::string_view(data_ + offset, key_len);
+            return end_offset == byte_size_ ? byte_size_ : end_offset + 1;
+        }
+
+        // A key cut by the end of the file is read as 0, FileKeyRNG stops at key_end_offset()
+        size_t ReadKey(size_t offset, uint64_t& key) const {
+            if (offset + sizeof(uint64_t) > byte_size_) {
+                key = 0;
+                return byte_size_;
+            }
+            memcpy(&key, data_ + offset, sizeof(uint64_t));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            key = __builtin_bswap64(key);
+#endif
+            return offset + sizeof(uint64_t);
+        }
+
+    protected:
+        MmapKeyFile(const char* data, size_t byte_size, KeyFileFormat format):
+                data_(data), byte_size_(byte_size), format_(format), key_num_(0), hit_key_num_(0),
+                held_out_offset_(0) {}
+
+        void CountKeys(size_t held_out_percent) {
+            if (format_ == KeyFileFormat::UINT64_LE) {
+                key_num_ = byte_size_ / sizeof(uint64_t);
+                hit_key_num_ = key_num_ - key_num_ * held_out_percent / 100UL;
+                held_out_offset_ = hit_key_num_ * sizeof(uint64_t);
+                return;
+            }
+            std::string_view key;
+            for (size_t offset = 0; offset < byte_size_;) {
+                offset = ReadKey(offset, key);
+                key_num_ += !key.empty();
+            }
+            hit_key_num_ = key_num_ - key_num_ * held_out_percent / 100UL;
+            size_t key_cnt = 0;
+            held_out_offset_ = 0;
+            while (key_cnt < hit_key_num_) {
+                held_out_offset_ = ReadKey(held_out_offset_, key);
+                key_cnt += !key.empty();
+            }
+        }
+
+        const char* data_;
+        size_t byte_size_;
+        KeyFileFormat format_;
+        size_t key_num_;
+        size_t hit_key_num_;
+        size_t held_out_offset_;
+    };
+
+} // namespace bench
@@ -27,7 +27,7 @@ def get_work_dir_paths():
 
 def get_exe_filepaths(build_dir_path):
     filename_list = [f for f in os.listdir(build_dir_path) if os.path.isfile(os.path.join(build_dir_path, f))]
-    exe_file_pattern = re.compile(r'bench_(.+)__(.+)')
+    exe_file_pattern = re.compile(r'^bench_(.+)__(.+)')
     exe_filename_list = []
     # map_name_list = []
     # hash_name_list = []
@@ -42,10 +42,13 @@ def get_exe_filepaths(build_dir_path):
 def main():
     argv_len = len(sys.argv)
     if argv_len < 3:
-        print("Invalid parameters!\nUsage: python3 run_bench.py seed export_data_directory")
+        print("Invalid parameters!\nUsage: python3 run_bench.py seed export_data_directory "
+              "[key_file [string|uint64]]")
         return
     seed = int(sys.argv[1])
     export_dir_path = sys.argv[2]
+    # the optional key file and its format are passed to each benchmark
+    key_file_args = sys.argv[3:5]
     print("Export test data to %s" % export_dir_path)
     root_dir_path, build_dir_path = get_work_dir_paths()
     exe_file_path_list = get_exe_filepaths(build_dir_path)
@@ -53,7 +56,7 @@ def main():
     print(exe_file_path_list)
     for exe_file_path in exe_file_path_list:
         call_arg_list = copy.deepcopy(run_command_prefix)
-        call_arg_list.extend([exe_file_path, str(seed), export_dir_path])
+        call_arg_list.extend([exe_file_path, str(seed), export_dir_path] + key_file_args)
         subprocess.run(call_arg_list)
 
 